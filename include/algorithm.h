@@ -2,24 +2,33 @@
 #define ALGORITHM_H
 
 #include <vector>
+#include "compressedgraph.h"
+#include "graph.h"
+#include "progress.h"
+#include "searchstats.h"
+#include "workspace.h"
 using namespace std;
 
 /**
- * @brief Represents a directed edge with a weight in the graph.
+ * @brief Largest edge weight for which Dijkstra on a CSR graph switches to the bucket queue.
  */
-struct Edge {
+const int BUCKET_QUEUE_MAX_WEIGHT = 256;
+
+/**
+ * @brief Distances and predecessors of every node from one source (a shortest-path tree).
+ */
+struct ShortestPathTree {
     /**
-     * @brief The index of the destination node.
+     * @brief distance[v] from the source, numeric_limits<int>::max() if v is unreachable.
      */
-    int toNode;
+    vector<int> distance;
 
     /**
-     * @brief The weight of the edge.
+     * @brief The node before v on its shortest path, -1 for the source and unreachable nodes.
      */
-    int weight;
+    vector<int> predecessor;
 };
 
-
 /**
  * @brief Generate a Directed graph with weighted edges.
  * @param num_nodes The total number of nodes in the graph.
@@ -40,17 +49,187 @@ vector<vector<Edge>> generateDirectedGraph(int num_nodes, int avg_degree, int mi
  */
 vector<vector<Edge>> generateDAGraph(int num_nodes, int avg_degree, int min_weight, int max_weight);
 
+/**
+ * @brief Generates a Directed graph with weighted edges directly in CSR form.
+ * @param num_nodes The total number of nodes in the graph.
+ * @param avg_degree The average number of outgoing edges per node.
+ * @param min_weight The minimum weight for any edge.
+ * @param max_weight The maximum weight for any edge.
+ * @return The graph in compressed sparse row form.
+ */
+CSRGraph generateDirectedGraphCSR(int num_nodes, int avg_degree, int min_weight, int max_weight);
+
+/**
+ * @brief Generates a reproducible Directed graph in CSR form, in parallel.
+ *
+ * Every node draws its edges from its own random stream derived from the
+ * seed, so the same seed gives the same graph for any thread count.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param avg_degree The number of outgoing edges per node (capped at num_nodes - 1).
+ * @param min_weight The minimum weight for any edge.
+ * @param max_weight The maximum weight for any edge.
+ * @param seed The seed of the random streams.
+ * @param num_threads The number of threads to use; 0 or less means one per hardware thread.
+ * @param progress If not null, receives the number of nodes whose edges are drawn and is checked for cancellation.
+ * @return The graph in compressed sparse row form.
+ * @throws Cancelled If progress was cancelled before the graph was complete.
+ */
+CSRGraph generateDirectedGraphCSR(int num_nodes, int avg_degree, int min_weight, int max_weight, unsigned long long seed, int num_threads = 0, Progress* progress = nullptr);
+
+/**
+ * @brief Generates a Directed Acyclic Graph (DA Graph) with weighted edges directly in CSR form.
+ * @param num_nodes The total number of nodes in the graph.
+ * @param avg_degree The average number of outgoing edges per node.
+ * @param min_weight The minimum weight allowed for any edge.
+ * @param max_weight The maximum weight allowed for any edge.
+ * @return The DA Graph in compressed sparse row form.
+ */
+CSRGraph generateDAGraphCSR(int num_nodes, int avg_degree, int min_weight, int max_weight);
+
+/**
+ * @brief Generates a reproducible Directed Acyclic Graph in CSR form, in parallel.
+ *
+ * Every node except 0 gets one edge from a random earlier node, plus about
+ * avg_degree * num_nodes additional edges sampled directly from the valid
+ * (from < to) pairs. Like generateDirectedGraphCSR, the same seed gives the
+ * same graph for any thread count.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param avg_degree The average number of additional outgoing edges per node.
+ * @param min_weight The minimum weight allowed for any edge.
+ * @param max_weight The maximum weight allowed for any edge.
+ * @param seed The seed of the random streams.
+ * @param num_threads The number of threads to use; 0 or less means one per hardware thread.
+ * @param progress If not null, receives the number of nodes whose edges are drawn and is checked for cancellation.
+ * @return The DA Graph in compressed sparse row form.
+ * @throws Cancelled If progress was cancelled before the graph was complete.
+ */
+CSRGraph generateDAGraphCSR(int num_nodes, int avg_degree, int min_weight, int max_weight, unsigned long long seed, int num_threads = 0, Progress* progress = nullptr);
+
 /**
  * @brief Computes the shortest path from a source node to a target node and its corresponding distance using the Dijkstra's algorithm.
  * @param num_nodes The total number of nodes in the graph.
  * @param source The source node.
  * @param target The target node.
  * @param adjacencyList The adjacency list representation of the graph.
+ * @param stats If not null, receives the counters of the search.
  * @return A pair containing:
  *    - A vector of node indices representing the shortest path from source to target.
  *    - An integer representing the total distance of that shortest path.
  */
-pair<vector<int>, int> Dijkstra(int num_nodes, int source, int target, const vector<vector<Edge>>& adjacencyList);
+pair<vector<int>, int> Dijkstra(int num_nodes, int source, int target, const vector<vector<Edge>>& adjacencyList, SearchStats* stats = nullptr);
+
+/**
+ * @brief Dijkstra's algorithm on a graph in CSR form.
+ *
+ * Graphs whose weights all lie in [1, BUCKET_QUEUE_MAX_WEIGHT] are handed to
+ * DijkstraBucket, which returns the same path and distance.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> Dijkstra(int num_nodes, int source, int target, const CSRGraph& graph, SearchStats* stats = nullptr);
+
+/**
+ * @brief Dijkstra's algorithm on a graph in CSR form, always using the binary heap.
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> DijkstraHeap(int num_nodes, int source, int target, const CSRGraph& graph, SearchStats* stats = nullptr);
+
+/**
+ * @brief Dijkstra's algorithm with a binary heap on a compressed graph, decoding the edges as it relaxes them.
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The compressed graph; weights must be non-negative.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> Dijkstra(int num_nodes, int source, int target, const CompressedGraph& graph, SearchStats* stats = nullptr);
+
+/**
+ * @brief Dijkstra's algorithm backed by a bucket queue (Dial's algorithm) instead of a binary heap.
+ *
+ * Nodes are kept in maxWeight() + 1 circular buckets indexed by distance, so every
+ * push and pop is O(1). Requires non-negative weights. When every weight is at
+ * least 1, ties are broken exactly like the heap-based Dijkstra, so both return
+ * the same path.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> DijkstraBucket(int num_nodes, int source, int target, const CSRGraph& graph, SearchStats* stats = nullptr);
+
+/**
+ * @brief Dijkstra on a CSR graph that keeps its search state in a reusable workspace.
+ *
+ * Returns the same path as the overload without a workspace, but nothing is
+ * allocated or cleared per node: a query only pays for the nodes it visits.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param workspace Search state reused across queries; one per thread.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> Dijkstra(int num_nodes, int source, int target, const CSRGraph& graph, QueryWorkspace& workspace, SearchStats* stats = nullptr);
+
+/**
+ * @brief Runs Dijkstra's algorithm from a source without a target and keeps the whole shortest-path tree.
+ *
+ * Uses the bucket queue under the same conditions as Dijkstra. Requires non-negative weights.
+ *
+ * @param graph The CSR representation of the graph.
+ * @param source The source node.
+ * @param stats If not null, receives the counters of the search.
+ * @param progress If not null, receives the number of settled nodes and is checked for cancellation.
+ * @return The distance and predecessor of every node.
+ * @throws Cancelled If progress was cancelled during the search.
+ */
+ShortestPathTree DijkstraTree(const CSRGraph& graph, int source, SearchStats* stats = nullptr, Progress* progress = nullptr);
+
+/**
+ * @brief Reads the path to a target out of a shortest-path tree.
+ * @param tree A tree computed from some source.
+ * @param target The target node.
+ * @return The path from the tree's source to target and its distance (empty path and
+ *         numeric_limits<int>::max() if the target is unreachable).
+ */
+pair<vector<int>, int> extractPath(const ShortestPathTree& tree, int target);
+
+/**
+ * @brief Bidirectional Dijkstra for a single source-target query.
+ *
+ * Grows one search forward from the source over graph and one backward from the
+ * target over reverseGraph, always expanding the side with the smaller queue key,
+ * and stops once the two keys add up to at least the best path seen so far.
+ * Requires non-negative weights.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param reverseGraph graph.reversed(), built once per graph and reused across queries.
+ * @param stats If not null, receives the counters of both searches together.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> BidirectionalDijkstra(int num_nodes, int source, int target, const CSRGraph& graph, const CSRGraph& reverseGraph, SearchStats* stats = nullptr);
 
 /**
  * @brief Computes the shortest path from a starting node to a target node and its corresponding distance using the Bellman-Ford algorithm.
@@ -58,10 +237,103 @@ pair<vector<int>, int> Dijkstra(int num_nodes, int source, int target, const vec
  * @param source The starting node.
  * @param target The ending node.
  * @param adjacencyList The adjacency list representation of the graph.
+ * @param stats If not null, receives the counters of the search.
  * @return A pair containing:
  *    - A vector of node indices representing the shortest path from source to target.
  *    - An integer representing the total distance of that shortest path.
  */
-pair<vector<int>, int> BellmanFord(int num_nodes, int source, int target, const vector<vector<Edge>>& adjacencyList);
+pair<vector<int>, int> BellmanFord(int num_nodes, int source, int target, const vector<vector<Edge>>& adjacencyList, SearchStats* stats = nullptr);
+
+/**
+ * @brief Bellman-Ford algorithm on a graph in CSR form.
+ * @param num_nodes The total number of vertices in the graph.
+ * @param source The starting node.
+ * @param target The ending node.
+ * @param graph The CSR representation of the graph.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> BellmanFord(int num_nodes, int source, int target, const CSRGraph& graph, SearchStats* stats = nullptr);
+
+/**
+ * @brief Bellman-Ford algorithm on a compressed graph, decoding every edge list in every round.
+ * @param num_nodes The total number of vertices in the graph.
+ * @param source The starting node.
+ * @param target The ending node.
+ * @param graph The compressed graph.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> BellmanFord(int num_nodes, int source, int target, const CompressedGraph& graph, SearchStats* stats = nullptr);
+
+/**
+ * @brief Bellman-Ford on a CSR graph that keeps its labels in a reusable workspace.
+ *
+ * Same result as the overload without a workspace, without the per-query allocations.
+ *
+ * @param num_nodes The total number of vertices in the graph.
+ * @param source The starting node.
+ * @param target The ending node.
+ * @param graph The CSR representation of the graph.
+ * @param workspace Search state reused across queries; one per thread.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> BellmanFord(int num_nodes, int source, int target, const CSRGraph& graph, QueryWorkspace& workspace, SearchStats* stats = nullptr);
+
+/**
+ * @brief Runs Bellman-Ford from one source over the whole graph.
+ * @param graph The CSR representation of the graph.
+ * @param source The source node.
+ * @param stats If not null, receives the counters of the search.
+ * @param progress If not null, is checked for cancellation every round and every few thousand nodes; the number of rounds is not known upfront.
+ * @return The distance and predecessor of every node.
+ * @throws Cancelled If progress was cancelled during the search.
+ */
+ShortestPathTree BellmanFordTree(const CSRGraph& graph, int source, SearchStats* stats = nullptr, Progress* progress = nullptr);
+
+/**
+ * @brief Computes the shortest path on a Directed Acyclic Graph by relaxing every edge once in topological order.
+ *
+ * Runs in O(V + E) and handles negative weights. Unless the caller vouches that
+ * node ids are already a topological order, the order is computed with Kahn's
+ * algorithm; if that finds a cycle the graph is not a DAG and the query falls
+ * back to Bellman-Ford.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param adjacencyList The adjacency list representation of the graph.
+ * @param topologicallyOrdered True if every edge goes from a lower to a higher node index (as generateDAGraph guarantees).
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> DAGShortestPath(int num_nodes, int source, int target, const vector<vector<Edge>>& adjacencyList, bool topologicallyOrdered = false, SearchStats* stats = nullptr);
+
+/**
+ * @brief DAG shortest path on a graph in CSR form, trusting graph.isTopologicallyOrdered().
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> DAGShortestPath(int num_nodes, int source, int target, const CSRGraph& graph, SearchStats* stats = nullptr);
+
+/**
+ * @brief Computes the shortest-path tree of a source on a DAG in O(V + E), relaxing every edge once in topological order.
+ *
+ * Trusts graph.isTopologicallyOrdered() like DAGShortestPath; otherwise the
+ * order is computed first, and a graph with a cycle falls back to Bellman-Ford.
+ *
+ * @param graph The CSR representation of the graph.
+ * @param source The source node.
+ * @param stats If not null, receives the counters of the search.
+ * @param progress If not null, receives the number of settled nodes and is checked for cancellation.
+ * @return The distance and predecessor of every node.
+ * @throws Cancelled If progress was cancelled during the search.
+ */
+ShortestPathTree DAGShortestPathTree(const CSRGraph& graph, int source, SearchStats* stats = nullptr, Progress* progress = nullptr);
 
 #endif //ALGORITHM_H
@@ -0,0 +1,219 @@
+#ifndef ALLPAIRS_H
+#define ALLPAIRS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "threadpool.h"
+using namespace std;
+
+/**
+ * @brief Version of the distance matrix file format written by JohnsonAllPairs.
+ */
+const uint32_t DISTANCE_FILE_VERSION = 1;
+
+/**
+ * @brief The fixed 64-byte header at the start of a distance matrix file.
+ *
+ * It is followed by numNodes rows of rowStride ints each, starting at byte 64;
+ * entry j of row i is the distance from i to j. Like graph files, values are
+ * stored in the byte order of the machine that wrote the file.
+ */
+struct DistanceFileHeader {
+    char magic[8];      // "DISTMTRX"
+    uint32_t version;   // DISTANCE_FILE_VERSION
+    uint32_t byteOrder; // 0x01020304 as written
+    int32_t numNodes;
+    int32_t rowStride;
+    uint32_t reserved[10];
+};
+static_assert(sizeof(DistanceFileHeader) == 64, "the distance file header must stay 64 bytes");
+
+struct AllPairsResult;
+
+/**
+ * @brief The instruction set of the min-plus kernel that FloydWarshall updates tiles with.
+ */
+enum class MinPlusKernel {
+    Auto,   // the widest one the processor supports
+    Scalar, // plain C++, available everywhere
+    SSE41,  // 4 ints per instruction
+    AVX2    // 8 ints per instruction
+};
+
+/**
+ * @brief A dense num_nodes x num_nodes matrix of shortest distances (or of next hops, see AllPairsResult).
+ *
+ * Rows are padded to a multiple of 16 ints and the first row starts on a
+ * 64-byte boundary, so every row begins on its own cache line and rows
+ * written by different threads never share one. Unreachable pairs hold
+ * numeric_limits<int>::max(). Copies share the same storage, which is either
+ * owned memory or a read-only mapping of a distance file.
+ */
+class DistanceMatrix
+{
+public:
+    /**
+     * @brief Constructs an empty matrix with no nodes.
+     */
+    DistanceMatrix();
+
+    /**
+     * @brief Allocates a matrix in which every pair is unreachable.
+     */
+    explicit DistanceMatrix(int num_nodes);
+
+    int numNodes() const { return nodes; }
+
+    /**
+     * @brief The number of ints from the start of one row to the start of the next.
+     */
+    size_t rowStride() const { return stride; }
+
+    /**
+     * @brief The distances from one node to every node, numNodes() of them.
+     */
+    const int *row(int from) const { return values + from * stride; }
+
+    /**
+     * @brief The distance from one node to another, numeric_limits<int>::max() if unreachable.
+     */
+    int at(int from, int to) const { return row(from)[to]; }
+
+    /**
+     * @brief Bytes the matrix occupies, padding included.
+     */
+    size_t memoryBytes() const { return static_cast<size_t>(nodes) * stride * sizeof(int); }
+
+private:
+    friend AllPairsResult JohnsonAllPairs(const CSRGraph &graph, ThreadPool &pool, const string &outputPath);
+    friend AllPairsResult FloydWarshall(const CSRGraph &graph, ThreadPool &pool, MinPlusKernel kernel);
+    friend DistanceMatrix loadDistanceMatrix(const string &path);
+
+    // Only matrices allocated in memory are written to
+    int *mutableRow(int from) { return const_cast<int *>(row(from)); }
+
+    shared_ptr<const void> storage; // keeps values alive
+    const int *values = nullptr;
+    int nodes = 0;
+    size_t stride = 0;
+};
+
+/**
+ * @brief The outcome of an all-pairs computation on a graph that may have negative weights.
+ */
+struct AllPairsResult {
+    /**
+     * @brief The distance of every pair; empty if a negative cycle was found.
+     */
+    DistanceMatrix distances;
+
+    /**
+     * @brief FloydWarshall only: the node after from on a shortest path from -> to, -1 if there is none.
+     */
+    DistanceMatrix nextHop;
+
+    /**
+     * @brief True if the graph contains a negative cycle, so shortest paths are undefined.
+     */
+    bool negativeCycle = false;
+
+    /**
+     * @brief The nodes of one such cycle in edge order (cycle[i] -> cycle[i + 1], last -> first).
+     */
+    vector<int> cycle;
+};
+
+/**
+ * @brief Computes the shortest distance between every pair of nodes with Johnson's algorithm.
+ *
+ * A Bellman-Ford pass from a virtual source joined to every node by a
+ * zero-weight edge gives each node a potential h(v) with
+ * w(u, v) + h(u) - h(v) >= 0 for every edge, or finds a negative cycle. The
+ * edges are reweighted by it and one Dijkstra per source runs on the pool,
+ * each writing its row in place; d(s, t) = d'(s, t) - h(s) + h(t) restores
+ * the original lengths. Graphs without negative weights skip the first pass,
+ * and topologically ordered ones (as generateDAGraphCSR makes) get their
+ * potentials from a single sweep in node order.
+ *
+ * With an output path the rows are computed in blocks and appended to a
+ * distance file, so only the graph and one block have to fit in memory; the
+ * returned matrix then maps that file.
+ *
+ * @param graph The CSR representation of the graph.
+ * @param pool The threads to run on.
+ * @param outputPath If not empty, the distance file to create or overwrite.
+ * @return The distance matrix, or the negative cycle that prevents one.
+ * @throws runtime_error If the output file cannot be written.
+ * @throws overflow_error If a reweighted edge does not fit in an int.
+ */
+AllPairsResult JohnsonAllPairs(const CSRGraph &graph, ThreadPool &pool, const string &outputPath = "");
+
+/**
+ * @brief Johnson's algorithm on a temporary pool of num_threads threads (0 or less: one per hardware thread).
+ */
+AllPairsResult JohnsonAllPairs(const CSRGraph &graph, int num_threads, const string &outputPath = "");
+
+/**
+ * @brief Computes the shortest distance and next hop between every pair of nodes with a cache-blocked Floyd-Warshall.
+ *
+ * The graph becomes a dense adjacency matrix, cut into 64 x 64 tiles. For
+ * every diagonal tile k, Floyd-Warshall first runs within that tile, then on
+ * the tiles of row and column k in parallel, then on all remaining tiles in
+ * parallel, so each step works on three tiles that fit in the L1/L2 cache.
+ * The inner min-plus loop is vectorized with the chosen kernel.
+ *
+ * It costs O(n^3) whatever the edge count, so it wins over JohnsonAllPairs on
+ * dense graphs only; the benchmark's --crossover study measures where.
+ *
+ * @param graph The CSR representation of the graph; parallel edges keep the lightest.
+ * @param pool The threads to run on.
+ * @param kernel The min-plus kernel; Auto picks bestMinPlusKernel().
+ * @return The distances and next hops, or the negative cycle that prevents them.
+ * @throws invalid_argument If the processor does not support the requested kernel.
+ * @throws overflow_error If a path could be too long for the int range the kernel works in.
+ */
+AllPairsResult FloydWarshall(const CSRGraph &graph, ThreadPool &pool, MinPlusKernel kernel = MinPlusKernel::Auto);
+
+/**
+ * @brief Floyd-Warshall on an adjacency list with a temporary pool of num_threads threads (0 or less: one per hardware thread).
+ */
+AllPairsResult FloydWarshall(const vector<vector<Edge>> &adjacencyList, int num_threads = 0, MinPlusKernel kernel = MinPlusKernel::Auto);
+
+/**
+ * @brief The widest min-plus kernel this processor and build support.
+ */
+MinPlusKernel bestMinPlusKernel();
+
+/**
+ * @brief Whether this processor and build support a min-plus kernel; Auto and Scalar always are.
+ */
+bool isMinPlusKernelSupported(MinPlusKernel kernel);
+
+/**
+ * @brief A short name of a kernel: "auto", "scalar", "sse4.1" or "avx2".
+ */
+const char *minPlusKernelName(MinPlusKernel kernel);
+
+/**
+ * @brief Follows the next hops of a FloydWarshall result from one node to another.
+ * @param result A result with next hops and without a negative cycle.
+ * @param from The source node.
+ * @param to The target node.
+ * @return The shortest path from from to to and its distance; an empty path if to is unreachable.
+ * @throws invalid_argument If result has no next hops.
+ */
+pair<vector<int>, int> extractPath(const AllPairsResult &result, int from, int to);
+
+/**
+ * @brief Maps a distance file written by JohnsonAllPairs into memory without reading it.
+ * @param path The distance file.
+ * @return A matrix that reads straight from the file.
+ * @throws runtime_error If the file cannot be opened or is not a valid distance file.
+ */
+DistanceMatrix loadDistanceMatrix(const string &path);
+
+#endif // ALLPAIRS_H
@@ -0,0 +1,86 @@
+#ifndef ALT_H
+#define ALT_H
+
+#include <cstddef>
+#include <vector>
+#include "graph.h"
+#include "searchstats.h"
+using namespace std;
+
+/**
+ * @brief How the landmarks of an ALTIndex are chosen.
+ */
+enum class LandmarkSelection {
+    Random,       // k distinct nodes drawn uniformly at random
+    FarthestPoint // each new landmark is the node farthest from the ones already chosen
+};
+
+/**
+ * @brief Landmark distance tables for ALT (A*, Landmarks, Triangle inequality) queries.
+ *
+ * Preprocessing runs one forward and one backward Dijkstra per landmark L and
+ * stores d(L, v) and d(v, L) for every node v. By the triangle inequality,
+ * max(d(L, t) - d(L, v), d(v, L) - d(t, L)) is a lower bound on d(v, t), which
+ * ALTDijkstra uses as its A* heuristic. Build the index once per graph and
+ * reuse it for every query on that graph. Requires non-negative weights.
+ */
+class ALTIndex
+{
+public:
+    /**
+     * @brief Selects the landmarks and computes their distance tables.
+     * @param graph The CSR representation of the graph.
+     * @param reverseGraph graph.reversed().
+     * @param numLandmarks The number of landmarks k.
+     * @param selection How the landmarks are picked.
+     * @param seed Seed for the random choices of the selection.
+     */
+    ALTIndex(const CSRGraph &graph,
+             const CSRGraph &reverseGraph,
+             int numLandmarks,
+             LandmarkSelection selection = LandmarkSelection::FarthestPoint,
+             unsigned seed = 0);
+
+    /**
+     * @brief Lower bound on the distance from a node to the target.
+     * @param node The node to estimate from.
+     * @param targetDistances The row of the target, from targetRow(target).
+     * @return A lower bound on d(node, target), never negative.
+     */
+    int lowerBound(int node, const int *targetDistances) const;
+
+    /**
+     * @brief The interleaved (from-landmark, to-landmark) distances of a node, 2k entries.
+     */
+    const int *targetRow(int node) const { return table.data() + static_cast<size_t>(node) * 2 * landmarkNodes.size(); }
+
+    /**
+     * @brief The chosen landmark nodes.
+     */
+    const vector<int> &landmarks() const { return landmarkNodes; }
+
+    /**
+     * @brief Bytes used by the landmark distance tables.
+     */
+    size_t memoryBytes() const { return table.size() * sizeof(int) + landmarkNodes.size() * sizeof(int); }
+
+private:
+    vector<int> landmarkNodes;
+    // node-major: for node v and landmark i, table[(v * k + i) * 2] = d(L_i, v)
+    // and table[(v * k + i) * 2 + 1] = d(v, L_i), so a query touches one row per node
+    vector<int> table;
+};
+
+/**
+ * @brief A* search guided by the landmark lower bounds of an ALTIndex.
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR graph the index was built for.
+ * @param index The landmark tables of that graph.
+ * @param stats If not null, receives the counters of the search.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> ALTDijkstra(int num_nodes, int source, int target, const CSRGraph& graph, const ALTIndex& index, SearchStats* stats = nullptr);
+
+#endif // ALT_H
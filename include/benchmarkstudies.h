@@ -0,0 +1,93 @@
+#ifndef BENCHMARKSTUDIES_H
+#define BENCHMARKSTUDIES_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "threadpool.h"
+using namespace std;
+
+// Default weight ranges per graph type, the GUI's (Const::DG_* and Const::DAG_* in constants.h,
+// which needs Qt): DAGs get negative weights, which Bellman-Ford and the DAG search handle
+const pair<int, int> DIRECTED_WEIGHTS = {1, 10};
+const pair<int, int> DAG_WEIGHTS = {-10, 10};
+
+/**
+ * @brief Everything a benchmark run can be configured with from the command line.
+ */
+struct BenchmarkOptions {
+    vector<string> algorithms = {"dijkstra", "bucket", "workspace", "bidirectional", "alt", "ch", "delta", "bellman-ford", "frontier-bf", "dag"};
+    bool defaultAlgorithms = true; // algorithms was not given on the command line
+    vector<string> graphTypes = {"directed", "dag"};
+    vector<int> sizes = {1000, 10000, 100000};
+    vector<int> degrees = {20};
+    vector<pair<int, int>> weightRanges; // empty: DIRECTED_WEIGHTS or DAG_WEIGHTS by graph type
+    vector<int> threads = {0};    // thread counts for the parallel algorithms; 0 is one per hardware thread
+    string file;                  // benchmark this graph file instead of generated graphs
+    unsigned long long seed = 42; // graphs and query pairs
+    int queries = 100;            // random query pairs per graph
+    int repetitions = 3;          // timed passes over the query pairs, and generator runs per graph
+    int warmup = 5;               // untimed queries per algorithm before its timed passes
+    int landmarks = 16;           // ALT landmarks
+    string study;                 // if set, run this study (its flag, e.g. --crossover) instead
+    vector<int> studySizes;       // the node counts given to the study
+    vector<double> densities = {0.01, 0.05, 0.1, 0.25, 0.5, 1.0}; // crossover degrees as fractions of num_nodes - 1
+    string jsonPath;
+    string csvPath;
+};
+
+/**
+ * @brief A study that runs instead of the query benchmark when its flag is given.
+ *
+ * run generates the study's graphs on the given node counts, prints its
+ * tables and writes the --json and --csv files.
+ */
+struct BenchmarkStudy {
+    string flag;  // e.g. --crossover; takes the node counts
+    string usage; // the help lines after the flag
+    function<void(const BenchmarkOptions &, const vector<unique_ptr<ThreadPool>> &)> run;
+};
+
+/**
+ * @brief Order statistics of per-query times, in seconds.
+ */
+struct TimeSummary {
+    int samples = 0;
+    double median = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double mean = 0;
+    double throughput = 0; // queries per second
+};
+
+/**
+ * @brief The studies the harness knows, in the order of the help text.
+ */
+vector<BenchmarkStudy> benchmarkStudies();
+
+/**
+ * @brief The weight ranges graphs of a type are generated with: --weights if given, else the type's default.
+ */
+vector<pair<int, int>> weightRangesFor(const BenchmarkOptions &options, const string &type);
+
+/**
+ * @brief Summarizes timing samples with nearest-rank percentiles.
+ * @param samples The samples in seconds, in any order.
+ * @return The summary; all zero if there are no samples.
+ */
+TimeSummary summarize(vector<double> samples);
+
+/**
+ * @brief The seconds elapsed since start.
+ */
+double secondsSince(chrono::steady_clock::time_point start);
+
+/**
+ * @brief Quotes and escapes text as a JSON string.
+ */
+string jsonString(const string &text);
+
+#endif // BENCHMARKSTUDIES_H
@@ -6,6 +6,27 @@ namespace Const{
     // Graph visual properties
     const int NODE_RADIUS = 15;
     const int GRAPH_RADIUS = 250;
+    const int NODE_SPACING = 45; // distance between neighbours on the circle once it outgrows GRAPH_RADIUS
+    const int BIDIRECTIONAL_OFFSET = 10; // how far the lower-to-higher edge of a pair is moved aside
+
+    // Force-directed layout: the distance it settles neighbours at, and how often the widget shows its progress
+    const double LAYOUT_EDGE_LENGTH = 100;
+    const int LAYOUT_SNAPSHOT_MS = 100;
+
+    // Level of detail: weight labels and node ids from LABEL_MIN_ZOOM on, arrowheads from
+    // ARROW_MIN_ZOOM, and node circles only while their radius is at least MIN_NODE_PIXELS on screen
+    const double LABEL_MIN_ZOOM = 0.5;
+    const double ARROW_MIN_ZOOM = 0.3;
+    const double MIN_NODE_PIXELS = 3;
+
+    // Zoom and pan: wheel step, largest zoom, smallest zoom as a fraction of the fitted one
+    const double ZOOM_STEP = 1.25;
+    const double MAX_ZOOM = 8;
+    const double MIN_ZOOM = 0.5;
+
+    // Graphs with more nodes and edges than this are redrawn only after the view rests this long
+    const int IMMEDIATE_REDRAW_ITEMS = 20000;
+    const int REDRAW_DELAY_MS = 150;
 
     // Arrow styling
     const double ARROW_SIZE = 10.0;
@@ -21,11 +42,21 @@ namespace Const{
     const int MIN_WIDGET_WIDTH = 800;
     const int MIN_WIDGET_HEIGHT = 600;
 
-    // Node numbers
+    // Node numbers; generation runs on a worker thread, so the upper limit is set by memory, not by the UI
     const int MIN_NODES_NUM = 3;
-    const int MAX_NODES_NUM = 10;
+    const int MAX_NODES_NUM = 1000000;
     const int DEFAULT_NODES_NUM = 5;
 
+    // Generated and loaded graphs: drawn up to this many nodes, node ids listed in the combo boxes up to the second
+    const int MAX_DRAWN_NODES = 100000;
+    const int MAX_LISTED_NODES = 1000;
+
+    // Background tasks: progress bar width and steps, polling interval, how long "cancelled" stays in the status bar
+    const int PROGRESS_BAR_WIDTH = 200;
+    const int PROGRESS_STEPS = 1000;
+    const int PROGRESS_INTERVAL_MS = 100;
+    const int STATUS_MESSAGE_MS = 5000;
+
     // Window title
     inline QString WINDOW_TITLE() {
         return "Graph Visualizer - Dijkstra & Bellman-Ford";
@@ -0,0 +1,111 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <cstddef>
+#include <vector>
+#include "graph.h"
+#include "searchstats.h"
+using namespace std;
+
+/**
+ * @brief A Contraction Hierarchies (CH) index for fast repeated point-to-point queries on a static graph.
+ *
+ * Nodes are contracted one at a time in order of increasing edge difference
+ * (shortcuts added minus edges removed). Contracting v adds a shortcut u -> x
+ * for every pair of neighbors whose only shortest connection runs through v;
+ * a bounded witness search decides that. A query is then a bidirectional
+ * Dijkstra that only walks towards higher-ranked nodes.
+ *
+ * Random graphs have no natural hierarchy, so contracting their last nodes
+ * creates dense cliques of shortcuts. Contraction therefore stops once the
+ * remaining nodes reach an average degree of coreDegreeLimit; they form an
+ * uncontracted core. A query climbs to the core with both upward searches and
+ * then finishes with a bidirectional Dijkstra inside it.
+ * Requires non-negative weights.
+ */
+class ContractionHierarchy
+{
+public:
+    /**
+     * @brief Contracts the graph and builds the upward and downward search graphs.
+     * @param adjacencyList The adjacency list representation of the graph.
+     * @param witnessSettleLimit The maximum number of nodes one witness search may settle.
+     * @param coreDegreeLimit Stop contracting once the remaining nodes average this many edges (in + out).
+     */
+    explicit ContractionHierarchy(const vector<vector<Edge>> &adjacencyList,
+                                  int witnessSettleLimit = 50,
+                                  double coreDegreeLimit = 60.0);
+
+    /**
+     * @brief Builds the index from a graph in CSR form.
+     */
+    explicit ContractionHierarchy(const CSRGraph &graph,
+                                  int witnessSettleLimit = 50,
+                                  double coreDegreeLimit = 60.0);
+
+    /**
+     * @brief Answers a shortest path query; shortcuts in the result are unpacked into original edges.
+     *
+     * The path has the same length as Dijkstra's; when several shortest paths exist it may be a different one.
+     *
+     * Reuses internal search buffers, so queries on one index must not run concurrently.
+     *
+     * @param source The source node.
+     * @param target The target node.
+     * @param stats If not null, receives the counters of both searches together.
+     * @return A shortest path from source to target and its total distance.
+     */
+    pair<vector<int>, int> query(int source, int target, SearchStats *stats = nullptr) const;
+
+    int numNodes() const { return static_cast<int>(rank.size()); }
+
+    /**
+     * @brief The number of shortcut edges stored in the index.
+     */
+    long long numShortcuts() const { return shortcuts; }
+
+    /**
+     * @brief The number of nodes left uncontracted in the core.
+     */
+    int coreSize() const { return core; }
+
+    /**
+     * @brief Bytes used by the search graphs and the node ranks.
+     */
+    size_t memoryBytes() const;
+
+private:
+    /**
+     * @brief An edge of the search graphs; middle is the contracted node a shortcut bypasses, -1 for original edges.
+     */
+    struct CHEdge {
+        int node;
+        int weight;
+        int middle;
+    };
+
+    void build(const CSRGraph &graph, int witnessSettleLimit, double coreDegreeLimit);
+    void unpack(int from, int to, int middle, vector<int> &path) const;
+    template<typename Stats>
+    pair<vector<int>, int> search(int source, int target, Stats &stats) const;
+    static const CHEdge *findEdge(const vector<int> &offsets, const vector<CHEdge> &edges, int node, int other);
+
+    vector<int> rank; // contraction order; every core node shares the highest rank
+
+    // upward[offsets] holds v -> x edges with rank[x] >= rank[v] (forward search),
+    // downward holds the reversed u -> v edges with rank[u] >= rank[v] (backward search)
+    vector<int> upOffsets;
+    vector<CHEdge> upEdges;
+    vector<int> downOffsets;
+    vector<CHEdge> downEdges;
+
+    long long shortcuts = 0;
+    int core = 0;
+
+    // Query buffers, reset through the touched list so a query costs only what it visits
+    mutable vector<int> distance[2];
+    mutable vector<int> predecessor[2];
+    mutable vector<int> touched;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
@@ -0,0 +1,119 @@
+#ifndef DYNAMICSSSP_H
+#define DYNAMICSSSP_H
+
+#include <vector>
+#include "algorithm.h"
+#include "graph.h"
+#include "searchstats.h"
+using namespace std;
+
+/**
+ * @brief A shortest-path tree from one source that is repaired, not recomputed, when edges change.
+ *
+ * The structure owns a mutable copy of the graph (out- and in-edge lists)
+ * and the tree. After an update only the nodes whose distance can change are
+ * searched again, in the style of Ramalingam and Reps:
+ *
+ * - A shorter edge u -> v (insert or decrease) can only lower distances. If it
+ *   improves v, a Dijkstra search starts at v and expands only nodes it improves.
+ * - A longer or removed edge u -> v can only raise distances, and only if it is
+ *   the tree edge into v. Then the subtree below v is cut off, every node in it
+ *   takes the best distance offered by an in-edge from outside the subtree, and
+ *   a Dijkstra search over the subtree alone settles the rest.
+ *
+ * Distances always equal those of a full recompute; among equally short paths
+ * the tree may pick a different one. There is at most one edge per ordered
+ * pair of nodes (the lightest of any parallel edges is kept), and weights must
+ * not be negative.
+ */
+class DynamicShortestPaths
+{
+public:
+    /**
+     * @brief Copies the graph and computes the initial tree with Dijkstra.
+     * @param graph The CSR representation of the graph; weights must not be negative.
+     * @param source The source node of the tree.
+     * @throws invalid_argument If the graph has a negative weight or source is not a node.
+     */
+    DynamicShortestPaths(const CSRGraph &graph, int source);
+
+    int source() const { return root; }
+    int numNodes() const { return static_cast<int>(outEdges.size()); }
+    long long numEdges() const { return edgeCount; }
+
+    /**
+     * @brief Adds the edge from -> to, or changes its weight if it exists.
+     * @param stats If not null, receives the counters of the repair.
+     * @throws invalid_argument If a node does not exist or the weight is negative.
+     */
+    void insertEdge(int from, int to, int weight, SearchStats *stats = nullptr);
+
+    /**
+     * @brief Removes the edge from -> to.
+     * @return False, and nothing changes, if there is no such edge.
+     * @throws invalid_argument If a node does not exist.
+     */
+    bool removeEdge(int from, int to, SearchStats *stats = nullptr);
+
+    /**
+     * @brief Changes the weight of the edge from -> to.
+     * @return False, and nothing changes, if there is no such edge.
+     * @throws invalid_argument If a node does not exist or the weight is negative.
+     */
+    bool setWeight(int from, int to, int weight, SearchStats *stats = nullptr);
+
+    /**
+     * @brief The weight of the edge from -> to, -1 if there is none.
+     */
+    int weight(int from, int to) const;
+
+    /**
+     * @brief The number of nodes the last update re-labelled: those it improved, or the subtree it cut off.
+     *
+     * The repair costs roughly this many nodes' worth of Dijkstra, against all of them for a recompute.
+     */
+    int affectedNodes() const { return lastAffected; }
+
+    /**
+     * @brief The outgoing edges of a node, in no particular order.
+     */
+    const vector<Edge> &edgesOf(int node) const { return outEdges[node]; }
+
+    int distance(int node) const { return spt.distance[node]; }
+    int predecessor(int node) const { return spt.predecessor[node]; }
+
+    /**
+     * @brief The current tree: distance and predecessor of every node.
+     */
+    const ShortestPathTree &tree() const { return spt; }
+
+    /**
+     * @brief The shortest path from the source to a target and its distance, read from the tree.
+     */
+    pair<vector<int>, int> path(int target) const { return extractPath(spt, target); }
+
+    /**
+     * @brief The current graph in CSR form, e.g. to check the tree against a full recompute.
+     */
+    CSRGraph toCSR() const;
+
+private:
+    void checkNode(int node) const;
+    void decreased(int from, int to, int weight, SearchStats &stats);
+    void increased(int from, int to, SearchStats &stats);
+    void updateEdge(int from, int to, int weight, SearchStats *stats);
+
+    int root;
+    long long edgeCount = 0;
+    int lastAffected = 0;
+    vector<vector<Edge>> outEdges;
+    vector<vector<Edge>> inEdges; // inEdges[v] holds (u, w) as an Edge to u for every edge u -> v
+    ShortestPathTree spt;
+
+    // Repair scratch, kept between updates
+    vector<pair<int, int>> heap;
+    vector<char> affected;
+    vector<int> subtree;
+};
+
+#endif // DYNAMICSSSP_H
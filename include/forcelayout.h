@@ -0,0 +1,138 @@
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include <vector>
+#include "graph.h"
+#include "threadpool.h"
+using namespace std;
+
+/**
+ * @brief A node position in layout coordinates.
+ */
+struct LayoutPoint {
+    double x = 0;
+    double y = 0;
+};
+
+/**
+ * @brief The parameters of a ForceLayout.
+ */
+struct LayoutOptions {
+    /**
+     * @brief The distance the forces settle adjacent nodes at, in layout units.
+     */
+    double edgeLength = 45;
+
+    /**
+     * @brief Barnes-Hut opening angle: a cell whose size is below theta times its distance counts as one body.
+     *
+     * 0 computes every pair exactly; larger values are faster and coarser.
+     */
+    double theta = 0.8;
+
+    /**
+     * @brief Strength of the pull towards the origin that keeps unconnected parts together.
+     */
+    double gravity = 0.02;
+
+    /**
+     * @brief Factor the largest step a node may take shrinks by after every iteration.
+     */
+    double cooling = 0.95;
+
+    /**
+     * @brief The layout counts as converged once the largest allowed step falls below edgeLength times this.
+     */
+    double minStep = 0.01;
+
+    /**
+     * @brief Iterations after which the layout stops whether or not it converged.
+     */
+    int maxIterations = 500;
+
+    /**
+     * @brief Seed of the random start positions.
+     */
+    unsigned long long seed = 1;
+};
+
+/**
+ * @brief Force-directed (Fruchterman-Reingold) graph layout with Barnes-Hut repulsion.
+ *
+ * Every node repels every other with force edgeLength^2 / distance, and
+ * every edge pulls its ends together with force distance^2 / edgeLength,
+ * regardless of direction and weight. Repulsion is approximated with a
+ * quadtree rebuilt every iteration: a distant cell acts as one body at its
+ * centre of mass, which takes an iteration from O(n^2) to O(n log n). The
+ * forces on all nodes are computed in parallel from the previous positions,
+ * so the result does not depend on the thread count. Each node then moves
+ * along its force by at most the current temperature, which cools down
+ * geometrically.
+ *
+ * The layout is refined step by step: run() does a few iterations and the
+ * positions can be read in between, e.g. to show them while the layout
+ * converges.
+ */
+class ForceLayout
+{
+public:
+    /**
+     * @brief Places the nodes at random in a disc that fits them at about edgeLength apart.
+     * @param graph The graph to lay out; it is copied into an undirected neighbour list.
+     * @param pool The threads to compute the forces on; must outlive the layout.
+     * @param options The layout parameters.
+     */
+    ForceLayout(const CSRGraph &graph, ThreadPool &pool, const LayoutOptions &options = LayoutOptions());
+
+    /**
+     * @brief Runs up to iterations iterations, fewer if the layout converges first.
+     * @return The number of iterations run.
+     */
+    int run(int iterations);
+
+    /**
+     * @brief True once the temperature fell below the minimum step or maxIterations were run.
+     */
+    bool converged() const;
+
+    int iteration() const { return iterations; }
+
+    /**
+     * @brief The largest distance a node may move in the next iteration.
+     */
+    double temperature() const { return heat; }
+
+    /**
+     * @brief The current position of every node.
+     */
+    const vector<LayoutPoint> &positions() const { return points; }
+
+private:
+    /**
+     * @brief A square of the quadtree. Leaves hold one body, or several that coincide at the depth limit.
+     */
+    struct Cell {
+        double x, y, size; // lower corner and side length
+        double massX = 0, massY = 0; // sum of the positions inside, the centre of mass once divided by mass
+        int mass = 0;
+        int body = -1; // the first node of a leaf, the others follow in sharing; -1 for internal cells
+        int children[4] = {-1, -1, -1, -1};
+    };
+
+    void buildTree();
+    void insert(int node);
+    LayoutPoint force(int node) const;
+
+    ThreadPool &pool;
+    LayoutOptions options;
+    CSRGraph neighbours; // the graph made undirected: springs pull along both directions of every edge
+    vector<LayoutPoint> points;
+    vector<LayoutPoint> next;
+    vector<Cell> cells;
+    vector<int> sharing; // the next node in the same leaf, -1 for the last
+    vector<int> order; // the nodes in depth-first order of the quadtree
+    double heat;
+    int iterations = 0;
+};
+
+#endif // FORCELAYOUT_H
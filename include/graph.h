@@ -0,0 +1,175 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <memory>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/**
+ * @brief Represents a directed edge with a weight in the graph.
+ */
+struct Edge {
+    /**
+     * @brief The index of the destination node.
+     */
+    int toNode;
+
+    /**
+     * @brief The weight of the edge.
+     */
+    int weight;
+};
+
+
+/**
+ * @brief An immutable directed graph in compressed sparse row (CSR) form.
+ *
+ * The outgoing edges of node u are stored contiguously at indices
+ * [edgesBegin(u), edgesEnd(u)) of the target and weight arrays, so the
+ * whole graph lives in three flat allocations instead of one per node.
+ *
+ * The arrays are immutable and shared: copying a graph is cheap and the
+ * copies use the same storage, which is either owned vectors or a view of
+ * memory someone else owns (such as a memory-mapped graph file).
+ */
+class CSRGraph
+{
+public:
+    /**
+     * @brief Constructs an empty graph with no nodes.
+     */
+    CSRGraph() = default;
+
+    /**
+     * @brief Builds a CSR graph from an adjacency list, keeping the edge order of every node.
+     * @param adjacencyList The adjacency list representation of the graph.
+     */
+    explicit CSRGraph(const vector<vector<Edge>> &adjacencyList);
+
+    /**
+     * @brief Builds a CSR graph from already laid out arrays.
+     * @param offsets num_nodes + 1 edge offsets; offsets[0] must be 0.
+     * @param targets The destination node of every edge.
+     * @param weights The weight of every edge.
+     * @param topologicallyOrdered True if every edge goes from a lower to a higher node index.
+     */
+    CSRGraph(vector<int> offsets, vector<int> targets, vector<int> weights, bool topologicallyOrdered = false);
+
+    /**
+     * @brief Builds a CSR graph from an unordered list of (from, edge) pairs.
+     *
+     * Edges leaving the same node keep their relative order.
+     *
+     * @param num_nodes The total number of nodes in the graph.
+     * @param edges The edges of the graph, each paired with its source node.
+     * @param topologicallyOrdered True if every edge goes from a lower to a higher node index.
+     * @return The CSR graph.
+     */
+    static CSRGraph fromEdgeList(int num_nodes, const vector<pair<int, Edge>> &edges, bool topologicallyOrdered = false);
+
+    /**
+     * @brief Wraps arrays that live elsewhere without copying them.
+     * @param owner Whatever keeps the arrays valid; it is released with the last copy of the graph.
+     * @param num_nodes The total number of nodes in the graph.
+     * @param num_edges The total number of edges in the graph.
+     * @param offsets num_nodes + 1 edge offsets.
+     * @param targets num_edges destination nodes.
+     * @param weights num_edges weights.
+     * @param minWeight The smallest weight in weights (0 without edges).
+     * @param maxWeight The largest weight in weights (0 without edges).
+     * @param topologicallyOrdered True if every edge goes from a lower to a higher node index.
+     * @return A graph reading straight from the given arrays.
+     */
+    static CSRGraph view(shared_ptr<const void> owner,
+                         int num_nodes,
+                         int num_edges,
+                         const int *offsets,
+                         const int *targets,
+                         const int *weights,
+                         int minWeight,
+                         int maxWeight,
+                         bool topologicallyOrdered = false);
+
+    /**
+     * @brief Converts the graph back to an adjacency list.
+     * @return The adjacency list representation of the graph.
+     */
+    vector<vector<Edge>> toAdjacencyList() const;
+
+    /**
+     * @brief Builds the reverse graph, in which every edge u -> v becomes v -> u with the same weight.
+     * @return The reversed graph.
+     */
+    CSRGraph reversed() const;
+
+    /**
+     * @brief Builds the undirected graph, in which every edge u -> v appears as both u -> v and v -> u with its weight.
+     *
+     * Self-loops are left out; parallel edges and edges present in both
+     * directions appear once per original edge.
+     *
+     * @return The undirected graph; the neighbours of u are its edges' targets.
+     */
+    CSRGraph undirected() const;
+
+    int numNodes() const { return nodeCount; }
+    int numEdges() const { return edgeCount; }
+
+    int edgesBegin(int node) const { return offsets[node]; }
+    int edgesEnd(int node) const { return offsets[node + 1]; }
+    int degree(int node) const { return offsets[node + 1] - offsets[node]; }
+
+    int target(int edge) const { return targets[edge]; }
+    int weight(int edge) const { return weights[edge]; }
+
+    /**
+     * @brief The smallest edge weight in the graph (0 for a graph without edges).
+     */
+    int minWeight() const { return minEdgeWeight; }
+
+    /**
+     * @brief The largest edge weight in the graph (0 for a graph without edges).
+     */
+    int maxWeight() const { return maxEdgeWeight; }
+
+    /**
+     * @brief Whether the producer guaranteed that node ids are a topological order (from < to on every edge).
+     */
+    bool isTopologicallyOrdered() const { return topological; }
+
+    /**
+     * @brief The raw arrays: numNodes() + 1 offsets, numEdges() targets and numEdges() weights.
+     */
+    const int *offsetsData() const { return offsets; }
+    const int *targetsData() const { return targets; }
+    const int *weightsData() const { return weights; }
+
+    /**
+     * @brief Calls visit(toNode, weight) for every outgoing edge of a node.
+     * @param node The node whose edges are visited.
+     * @param visit The callback invoked per edge.
+     */
+    template<typename Visitor>
+    void forEachEdge(int node, Visitor &&visit) const {
+        const int end = offsets[node + 1];
+        for (int i = offsets[node]; i < end; i++) {
+            visit(targets[i], weights[i]);
+        }
+    }
+
+private:
+    void computeWeightRange();
+
+    shared_ptr<const void> storage; // keeps the arrays below alive
+    int nodeCount = 0;
+    int edgeCount = 0;
+    const int *offsets = nullptr; // offsets[u]..offsets[u + 1] index the edges of node u
+    const int *targets = nullptr; // destination node of every edge
+    const int *weights = nullptr; // weight of every edge
+    int minEdgeWeight = 0;
+    int maxEdgeWeight = 0;
+    bool topological = false; // set by generators that only emit from < to edges
+};
+
+#endif // GRAPH_H
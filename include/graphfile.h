@@ -0,0 +1,71 @@
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H
+
+#include <cstdint>
+#include <string>
+#include "graph.h"
+using namespace std;
+
+/**
+ * @brief Version of the binary graph format written by saveGraph.
+ */
+const uint32_t GRAPH_FILE_VERSION = 1;
+
+/**
+ * @brief The fixed 64-byte header at the start of a binary graph file.
+ *
+ * It is followed by the arrays offsets (numNodes + 1 ints), targets and
+ * weights (numEdges ints each) and, if the reverse flag is set, the same three
+ * arrays of the reversed graph. Every array starts at a multiple of 64 bytes.
+ * All values are stored in the byte order of the machine that wrote the file;
+ * byteOrder lets a reader detect a mismatch.
+ */
+struct GraphFileHeader {
+    char magic[8];      // "CSRGRAPH"
+    uint32_t version;   // GRAPH_FILE_VERSION
+    uint32_t byteOrder; // 0x01020304 as written
+    uint32_t flags;     // GRAPH_FILE_TOPOLOGICAL | GRAPH_FILE_REVERSE
+    int32_t numNodes;
+    int32_t numEdges;
+    int32_t minWeight;
+    int32_t maxWeight;
+    uint32_t reserved[7];
+};
+static_assert(sizeof(GraphFileHeader) == 64, "the graph file header must stay 64 bytes");
+
+/**
+ * @brief Header flag: node ids are a topological order.
+ */
+const uint32_t GRAPH_FILE_TOPOLOGICAL = 1u << 0;
+
+/**
+ * @brief Header flag: the file also stores the reversed graph.
+ */
+const uint32_t GRAPH_FILE_REVERSE = 1u << 1;
+
+/**
+ * @brief Writes a graph to a binary file in one sequential pass.
+ * @param path The file to create or overwrite.
+ * @param graph The graph to store.
+ * @param includeReverse Also store graph.reversed(), for algorithms that search backwards.
+ * @throws runtime_error If the file cannot be written.
+ */
+void saveGraph(const string &path, const CSRGraph &graph, bool includeReverse = false);
+
+/**
+ * @brief Maps a binary graph file into memory and returns a graph that reads straight from it.
+ *
+ * Nothing is copied; the arrays are read once to check that the offsets
+ * increase, every target is a node, and the weight range and topological
+ * flag in the header hold, since searches trust all of them. Pages are shared
+ * by every process that maps the same file. The mapping is released with the
+ * last copy of the returned graph.
+ *
+ * @param path The file written by saveGraph.
+ * @param reverseGraph If not null, receives the reversed graph: mapped if the file has one, built otherwise.
+ * @return The graph.
+ * @throws runtime_error If the file cannot be opened or is not a valid graph file.
+ */
+CSRGraph loadGraph(const string &path, CSRGraph *reverseGraph = nullptr);
+
+#endif // GRAPHFILE_H
@@ -0,0 +1,43 @@
+#ifndef GRAPHIMPORT_H
+#define GRAPHIMPORT_H
+
+#include <string>
+#include "graph.h"
+#include "threadpool.h"
+using namespace std;
+
+/**
+ * @brief The layout of a graph file read by importGraph.
+ */
+enum class GraphFormat {
+    Auto,     // binary if the file starts with the graph file magic, DIMACS for .gr files or "c"/"p" lines, else an edge list
+    Binary,   // the memory-mapped format written by saveGraph
+    Dimacs,   // DIMACS shortest-path format: "p sp <nodes> <arcs>" then "a <from> <to> <weight>" with 1-based ids; "c" lines are comments
+    EdgeList  // one "<from> <to> [weight]" line per edge with 0-based ids; a missing weight is 1, "#" and "%" lines are comments
+};
+
+/**
+ * @brief Reads a graph from a file on disk.
+ *
+ * Text files are streamed in fixed-size chunks that end on a line boundary;
+ * each chunk is split into pieces that are parsed in parallel with a plain
+ * integer scanner. The file is read twice (three times for an edge list, whose
+ * node count is not declared up front): once to count the out-degree of every
+ * node and once to write every edge straight into its CSR slot, so the edges
+ * are never held in a second representation. The edges of every node end up
+ * sorted by (target, weight), independent of the thread count.
+ *
+ * @param path The file to read.
+ * @param format The format of the file.
+ * @param pool The threads that parse the text.
+ * @return The graph.
+ * @throws runtime_error If the file cannot be read or is malformed; the message names the offending line.
+ */
+CSRGraph importGraph(const string &path, GraphFormat format, ThreadPool &pool);
+
+/**
+ * @brief Reads a graph from a file on a temporary pool of num_threads threads (0 or less: one per hardware thread).
+ */
+CSRGraph importGraph(const string &path, GraphFormat format = GraphFormat::Auto, int num_threads = 0);
+
+#endif // GRAPHIMPORT_H
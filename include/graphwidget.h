@@ -1,18 +1,42 @@
 #ifndef GRAPHWIDGET_H
 #define GRAPHWIDGET_H
 
+#include <QFont>
+#include <QFuture>
+#include <QLineF>
+#include <QPixmap>
+#include <QPointF>
+#include <QRectF>
+#include <QThreadPool>
 #include <QWidget>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include "algorithm.h"
+#include "progress.h"
 using namespace std;
 
+class QTimer;
 
 /**
  * @brief A custom QWidget for visualizing graphs and shortest paths.
  *
- * This widget displays a directed graph using circular node layout and
- * draws arrows between connected nodes. It also supports rendering
- * the shortest path between two nodes using a highlighted color.
+ * This widget displays a directed graph and draws arrows between connected
+ * nodes. It also supports rendering the shortest path between two nodes
+ * using a highlighted color.
+ *
+ * setGraph first places the nodes on a circle. A force-directed layout
+ * (ForceLayout) is then computed on a worker thread, and its intermediate
+ * positions replace the circle every LAYOUT_SNAPSHOT_MS until it
+ * converges, so large graphs untangle while they are shown. Edge geometry
+ * is recomputed only when the positions change. The graph
+ * itself is rendered into a cached pixmap that is only redrawn when the view
+ * changes; the highlighted path is drawn over it on every repaint. Only
+ * what lies in the viewport is drawn, and zoomed out, weight labels, node
+ * ids and arrowheads are left out and nodes become dots. The mouse wheel
+ * zooms around the cursor, dragging pans and a double click fits the graph
+ * into the widget again. On large graphs the cached pixmap is stretched and
+ * moved while the view changes and redrawn once it rests.
  */
 class GraphWidget : public QWidget
 {
@@ -24,11 +48,17 @@ public:
      */
     explicit GraphWidget(QWidget *parent = nullptr);
 
+    /**
+     * @brief Stops a running layout and waits for its thread.
+     */
+    ~GraphWidget();
+
     /**
      * @brief Sets the graph to be visualized.
      *
      * The graph should be provided as an adjacency list.
-     * Calling this function triggers a repaint of the widget.
+     * Calling this function lays it out on a circle, fits it into the widget and triggers a repaint.
+     * The force-directed layout of a previous graph is stopped and one for this graph is started.
      *
      * @param graph The graph represented as an adjacency list.
      */
@@ -43,9 +73,18 @@ public:
      *
      * @param path A vector of node indices representing the path.
      */
-
     void setPath(const vector<int> &path);
 
+    /**
+     * @brief Zooms and centers the view so that the whole graph is visible, at most at its natural size.
+     */
+    void fitToView();
+
+    /**
+     * @brief Stops refining the layout; the nodes stay where they are.
+     */
+    void stopLayout();
+
 protected:
     /**
      * @brief Handles the paint event to draw the graph and the path.
@@ -53,10 +92,60 @@ protected:
      */
     void paintEvent(QPaintEvent *event) override;
 
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
 private:
+    /**
+     * @brief The drawn part of an edge, in layout coordinates.
+     */
+    struct EdgeShape {
+        QLineF line;     // from the rim of the source circle to the rim of the target circle
+        QPointF labelAt; // where the weight label starts
+        int weight;
+    };
+
+    double fitScale() const;
+    void layoutGraph();
+    void startLayout();
+    void applyLayout(const vector<QPointF> &layout);
+    void computeGeometry();
+    void renderLayer();
+    void viewChanged();
+    QRectF visibleArea() const;
+
     vector<vector<Edge>> graph; // The current graph to visualize
     vector<int> path; // The current path to highlight
 
+    vector<QPointF> positions; // node centres in layout coordinates
+    vector<EdgeShape> edges; // every edge of graph, in adjacency-list order
+    unordered_map<long long, int> edgeAt; // (from, to) -> index in edges, also answers "is there a reverse edge"
+    QRectF bounds; // the layout, node circles included
+    QFont labelFont; // font of the weight labels
+
+    // The view: a layout point p is shown at p * scale + offset
+    double scale = 1;
+    QPointF offset;
+    bool fitted = true; // the view is the fitted one, so it follows resizes
+
+    QPixmap layer; // nodes, edges and labels as drawn for layerScale and layerOffset
+    double layerScale = 0;
+    QPointF layerOffset;
+    bool layerValid = false;
+    QTimer *redrawTimer; // redraws the layer once the view stops changing
+
+    QThreadPool layoutThread; // runs the force-directed layout, so it never waits for or delays other tasks
+    QFuture<void> layoutTask;
+    shared_ptr<Progress> layoutProgress; // cancels the running layout
+    int layoutGeneration = 0; // snapshots of the layout of an earlier graph are ignored
+
+    bool dragging = false;
+    QPointF dragFrom; // the cursor position the current drag last moved the view to
+
 signals:
 };
 
@@ -2,8 +2,17 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <functional>
+#include <memory>
 #include <vector>
 #include "graphwidget.h"
+#include "progress.h"
+#include "treecache.h"
+
+class QProgressBar;
+class QPushButton;
+class QStackedLayout;
+class QTimer;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -18,8 +27,13 @@ QT_END_NAMESPACE
  * visualization logic. It allows the user to:
  * - Select graph parameters (node count, graph type)
  * - Generate a graph (either Directed or DAG)
+ * - Load a graph from a DIMACS, edge-list or binary graph file
  * - Select two nodes and compute the shortest path
  * - Display the graph and highlighted path using a GraphWidget
+ *
+ * Generating, loading and path queries run on a worker thread, one at a time,
+ * so the window stays responsive on large graphs; a progress bar and a cancel
+ * button in the status bar follow the running task.
  */
 class MainWindow : public QMainWindow
 {
@@ -38,8 +52,40 @@ public:
     ~MainWindow();
 
 private:
+    /**
+     * @brief Runs work on a worker thread and then done with its result on the GUI thread.
+     *
+     * The buttons are disabled meanwhile. If work throws, or the task is
+     * cancelled, done is not called; errors are shown in a message box.
+     *
+     * @param task A short name of the task for the status bar and error messages.
+     * @param work The computation; it reports to and checks the given Progress.
+     * @param done What to do with the result.
+     */
+    template<typename Result>
+    void runInBackground(const QString &task, std::function<Result(Progress &)> work, std::function<void(Result)> done);
+
+    /**
+     * @brief Makes a generated or loaded graph the current one.
+     * @param csr The graph.
+     * @param drawn Its adjacency list if it is small enough to draw, otherwise empty.
+     * @param origin "Generated" or "Loaded", for the text shown instead of a graph too large to draw.
+     */
+    void showGraph(const CSRGraph &csr, const std::vector<std::vector<Edge>> &drawn, const QString &origin);
+
+    void setBusy(const QString &task);
+    void setIdle();
+    void updateProgress();
+
     Ui::MainWindow *ui; // Pointer to the auto-generated UI object
     GraphWidget *graphWidget; // Widget used for visualizing the graph and paths
-    std::vector<std::vector<Edge>> graph; // The current graph represented as an adjacency list
+    QStackedLayout *stackedLayout; // Instruction text (index 0) or graph view (index 1)
+    QProgressBar *progressBar; // Progress of the running task, in the status bar
+    QPushButton *cancelButton; // Cancels the running task
+    QTimer *progressTimer; // Polls the progress of the running task
+    std::shared_ptr<Progress> progress; // Progress of the running task; null while idle
+    std::vector<std::vector<Edge>> graph; // The current graph as an adjacency list; empty if it is too large to draw
+    CSRGraph currentGraph; // The current graph, generated or loaded
+    ShortestPathTreeCache treeCache; // Trees of recently used source nodes of the current graph
 };
 #endif // MAINWINDOW_H
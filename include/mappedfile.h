@@ -0,0 +1,43 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+using namespace std;
+
+/**
+ * @brief A read-only mapping of a whole file, unmapped on destruction.
+ *
+ * The operating system loads pages on first access and shares them between
+ * every process that maps the same file, so data far larger than RAM can be
+ * read through it. Hold it in a shared_ptr to keep pointers into it valid.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Maps the file; an empty file gives a null data() and size() 0.
+     * @throws runtime_error If the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const string &path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    void close();
+
+#ifdef _WIN32
+    void *file = nullptr;    // HANDLE
+    void *mapping = nullptr; // HANDLE
+#endif
+    const char *bytes = nullptr;
+    size_t length = 0;
+};
+
+#endif // MAPPEDFILE_H
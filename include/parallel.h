@@ -0,0 +1,124 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <vector>
+#include "algorithm.h"
+#include "graph.h"
+#include "progress.h"
+#include "threadpool.h"
+using namespace std;
+
+/**
+ * @brief The outcome of a Bellman-Ford run that can detect negative cycles.
+ */
+struct BellmanFordResult {
+    /**
+     * @brief The shortest path from source to target; empty if the target is unreachable or a negative cycle was found.
+     */
+    vector<int> path;
+
+    /**
+     * @brief The length of path, numeric_limits<int>::max() if there is none.
+     */
+    int distance;
+
+    /**
+     * @brief True if a negative cycle is reachable from the source, so shortest paths are undefined.
+     */
+    bool negativeCycle = false;
+
+    /**
+     * @brief The nodes of one such cycle in edge order (cycle[i] -> cycle[i + 1], last -> first).
+     */
+    vector<int> cycle;
+};
+
+/**
+ * @brief The sequential algorithm that answers each source of a query batch.
+ */
+enum class BatchAlgorithm {
+    Dijkstra,   // non-negative weights
+    BellmanFord // any weights; negative cycles are not detected
+};
+
+/**
+ * @brief Computes a shortest-path tree with parallel delta-stepping.
+ *
+ * Nodes are kept in buckets of width delta by tentative distance. The lowest
+ * non-empty bucket is emptied in rounds: every round relaxes the light edges
+ * (weight <= delta) of all its nodes in parallel, which may refill the same
+ * bucket. Once it stays empty, the heavy edges of every node it held are
+ * relaxed once, in parallel. Distance updates are lock-free atomic minimums.
+ *
+ * The distances equal Dijkstra's. Among equally short paths whose last edge
+ * has a positive weight the predecessor with the smallest index wins, so such
+ * nodes do not depend on the thread count either; over zero-weight edges the
+ * first predecessor found is kept, which keeps the tree free of cycles.
+ * Requires non-negative weights.
+ *
+ * @param graph The CSR representation of the graph.
+ * @param source The source node.
+ * @param delta The bucket width; 0 or less picks max weight / average degree.
+ * @param pool The threads to run on.
+ * @return The distance and predecessor of every node.
+ */
+ShortestPathTree DeltaSteppingTree(const CSRGraph& graph, int source, int delta, ThreadPool& pool);
+
+/**
+ * @brief Computes the shortest path from a source node to a target node with parallel delta-stepping.
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param delta The bucket width; 0 or less picks one from the weights.
+ * @param num_threads The number of threads to use; 0 or less means one per hardware thread.
+ * @return The shortest path from source to target and its total distance.
+ */
+pair<vector<int>, int> DeltaStepping(int num_nodes, int source, int target, const CSRGraph& graph, int delta, int num_threads);
+
+/**
+ * @brief Bellman-Ford that only relaxes the out-edges of nodes whose distance changed in the previous round.
+ *
+ * Every round processes its frontier in parallel with atomic (distance,
+ * predecessor) updates, which only replace a label with a strictly shorter
+ * distance; that way a cycle in the predecessor graph always has negative
+ * weight, even with zero-weight edges. A negative cycle makes relaxations go
+ * on forever and eventually closes such a cycle; the predecessor graph is
+ * checked for one after every power-of-two round, once num_nodes rounds have
+ * passed and before the path is read out, so a cycle is reported instead of a
+ * path. Of several shortest paths the one returned may depend on the thread
+ * count.
+ *
+ * @param num_nodes The total number of nodes in the graph.
+ * @param source The source node.
+ * @param target The target node.
+ * @param graph The CSR representation of the graph.
+ * @param pool The threads to run on.
+ * @param progress If not null, receives the number of rounds and is checked for cancellation before each one.
+ * @return The shortest path, or the negative cycle that prevents one.
+ * @throws Cancelled If progress was cancelled before the last round.
+ */
+BellmanFordResult BellmanFordFrontier(int num_nodes, int source, int target, const CSRGraph& graph, ThreadPool& pool, Progress* progress = nullptr);
+
+/**
+ * @brief Frontier Bellman-Ford on a temporary pool of num_threads threads (0 or less: one per hardware thread).
+ */
+BellmanFordResult BellmanFordFrontier(int num_nodes, int source, int target, const CSRGraph& graph, int num_threads, Progress* progress = nullptr);
+
+/**
+ * @brief Answers many (source, target) queries on one graph, spread over a thread pool.
+ *
+ * Queries are grouped by source and every group runs on one worker. A group
+ * with several targets is answered from a single shortest-path tree, so each
+ * distinct source is searched only once; a lone Dijkstra query still stops
+ * at its target.
+ *
+ * @param graph The CSR representation of the graph.
+ * @param queries The (source, target) pairs.
+ * @param algorithm The algorithm run per source.
+ * @param pool The threads to run on.
+ * @return The shortest path and distance of every query, in the order of queries.
+ */
+vector<pair<vector<int>, int>> BatchShortestPaths(const CSRGraph& graph, const vector<pair<int, int>>& queries, BatchAlgorithm algorithm, ThreadPool& pool);
+
+#endif // PARALLEL_H
@@ -0,0 +1,61 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <string>
+using namespace std;
+
+/**
+ * @brief Hardware cache counters of the calling thread, read through Linux perf events.
+ *
+ * Counts last-level cache references and misses and L1 data cache read
+ * misses in user space between start() and stop(). The counters are not
+ * available on other systems, without a PMU (as in many virtual machines)
+ * or when perf_event_paranoid forbids them; then available() is false,
+ * start() and stop() do nothing and every count is -1. Counters opened
+ * after the first one that fails are not opened either, so a run reports
+ * all three or none.
+ */
+class PerfCounters
+{
+public:
+    /**
+     * @brief Opens the counters, stopped and at zero.
+     */
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available() const { return group >= 0; }
+
+    /**
+     * @brief Why the counters are not available, empty if they are.
+     */
+    const string &error() const { return reason; }
+
+    /**
+     * @brief Resets the counters to zero and starts counting.
+     */
+    void start();
+
+    /**
+     * @brief Stops counting and reads the counts.
+     */
+    void stop();
+
+    long long cacheReferences() const { return references; }
+    long long cacheMisses() const { return misses; }
+    long long l1ReadMisses() const { return l1Misses; }
+
+private:
+    int group = -1;   // the group leader, counting cache references
+    int missFd = -1;  // last-level cache misses
+    int l1Fd = -1;    // L1 data cache read misses
+    string reason;
+    long long references = -1;
+    long long misses = -1;
+    long long l1Misses = -1;
+};
+
+#endif // PERFCOUNTERS_H
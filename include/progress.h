@@ -0,0 +1,76 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+using namespace std;
+
+/**
+ * @brief Thrown by a computation that stopped early because its Progress was cancelled.
+ */
+class Cancelled : public runtime_error
+{
+public:
+    Cancelled() : runtime_error("cancelled") {}
+};
+
+/**
+ * @brief Shared between a long computation and the thread waiting for it.
+ *
+ * The computation reports how much of its work is done; the other side
+ * reads that and may ask it to stop. Cancellation is cooperative: the
+ * computation checks at regular points (every few thousand settled nodes,
+ * every Bellman-Ford round, every chunk of generated nodes) and then throws
+ * Cancelled. All methods may be called from any thread.
+ */
+class Progress
+{
+public:
+    /**
+     * @brief Asks the computation to stop at its next check.
+     */
+    void cancel() { stopRequested.store(true, memory_order_relaxed); }
+
+    bool cancelled() const { return stopRequested.load(memory_order_relaxed); }
+
+    /**
+     * @brief Throws Cancelled if cancel() was called; the check points of a computation.
+     */
+    void throwIfCancelled() const {
+        if (cancelled()) {
+            throw Cancelled();
+        }
+    }
+
+    /**
+     * @brief Starts a new stage of total units of work (0 if the amount is not known upfront).
+     */
+    void start(long long total) {
+        doneWork.store(0, memory_order_relaxed);
+        totalWork.store(total, memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records that amount more units of the current stage are done.
+     */
+    void advance(long long amount) { doneWork.fetch_add(amount, memory_order_relaxed); }
+
+    long long done() const { return doneWork.load(memory_order_relaxed); }
+    long long total() const { return totalWork.load(memory_order_relaxed); }
+
+    /**
+     * @brief The finished part of the current stage in [0, 1], or -1 if its size is not known.
+     */
+    double fraction() const {
+        const long long all = total();
+        return all > 0 ? min(1.0, static_cast<double>(done()) / all) : -1;
+    }
+
+private:
+    atomic<bool> stopRequested{false};
+    atomic<long long> doneWork{0};
+    atomic<long long> totalWork{0};
+};
+
+#endif // PROGRESS_H
@@ -0,0 +1,132 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "algorithm.h"
+#include "graph.h"
+#include "searchstats.h"
+using namespace std;
+
+/**
+ * @brief The ways nodes can be relabelled to bring nodes that are searched together close in memory.
+ */
+enum class NodeOrder {
+    Original,             // keep the ids
+    BFS,                  // breadth-first order along the out-edges, from node 0 and then every unreached node
+    ReverseCuthillMcKee,  // Reverse Cuthill-McKee on the undirected graph: a low-bandwidth order
+    Degree                // by decreasing out-degree, so the most relaxed-from nodes share cache lines
+};
+
+/**
+ * @brief The name of an order as the benchmark takes it: original, bfs, rcm or degree.
+ */
+string nodeOrderName(NodeOrder order);
+
+/**
+ * @brief Parses the name of an order.
+ * @throws invalid_argument If the name is not one of nodeOrderName's.
+ */
+NodeOrder parseNodeOrder(const string &name);
+
+/**
+ * @brief Computes a relabelling of the nodes.
+ * @param graph The graph to relabel.
+ * @param order The order to use.
+ * @return The old id of every new id: node newToOld[i] of the graph becomes node i.
+ */
+vector<int> computeNodeOrder(const CSRGraph &graph, NodeOrder order);
+
+/**
+ * @brief Relabels the nodes of a graph.
+ * @param graph The graph to relabel.
+ * @param newToOld The old id of every new id, a permutation of 0..numNodes() - 1.
+ * @return The graph in which node i has the edges of node newToOld[i], with their targets relabelled too.
+ */
+CSRGraph permuteGraph(const CSRGraph &graph, const vector<int> &newToOld);
+
+/**
+ * @brief A graph with its nodes relabelled for cache locality, queried in the original ids.
+ *
+ * Generated graphs connect random ids, so every relaxation of a search
+ * touches a random cache line of the distance array. After relabelling in
+ * BFS or Reverse Cuthill-McKee order, the targets of a node's edges mostly
+ * have ids close to its own.
+ *
+ * The queries take and return original ids: the source and target are
+ * mapped to the new ids, and the path is mapped back. Paths are as short as
+ * on the original graph; of several shortest paths another one may be
+ * returned.
+ */
+class ReorderedGraph
+{
+public:
+    /**
+     * @brief Computes the order and builds the relabelled graph.
+     * @param graph The graph in original ids.
+     * @param order The order to relabel in.
+     */
+    ReorderedGraph(const CSRGraph &graph, NodeOrder order);
+
+    /**
+     * @brief The relabelled graph; its node ids are the new ones.
+     */
+    const CSRGraph &graph() const { return reordered; }
+
+    /**
+     * @brief The forward permutation: oldToNew[v] is the new id of original node v.
+     */
+    const vector<int> &forward() const { return oldToNew; }
+
+    /**
+     * @brief The inverse permutation: newToOld[i] is the original id of new node i.
+     */
+    const vector<int> &inverse() const { return newToOld; }
+
+    int toReordered(int node) const { return oldToNew[node]; }
+    int toOriginal(int node) const { return newToOld[node]; }
+
+    /**
+     * @brief Dijkstra with a binary heap on the relabelled graph.
+     * @param source The source node, in original ids.
+     * @param target The target node, in original ids.
+     * @param stats If not null, receives the counters of the search.
+     * @return The shortest path in original ids and its total distance.
+     */
+    pair<vector<int>, int> dijkstra(int source, int target, SearchStats *stats = nullptr) const;
+
+    /**
+     * @brief Bellman-Ford on the relabelled graph.
+     * @param source The source node, in original ids.
+     * @param target The target node, in original ids.
+     * @param stats If not null, receives the counters of the search.
+     * @return The shortest path in original ids and its total distance.
+     */
+    pair<vector<int>, int> bellmanFord(int source, int target, SearchStats *stats = nullptr) const;
+
+    /**
+     * @brief The shortest-path tree of a source on the relabelled graph, indexed by original ids.
+     * @param source The source node, in original ids.
+     * @param stats If not null, receives the counters of the search.
+     * @return The distance and the predecessor (an original id) of every original node.
+     */
+    ShortestPathTree tree(int source, SearchStats *stats = nullptr) const;
+
+    /**
+     * @brief Maps a path in new ids back to original ids; the distance is unchanged.
+     */
+    pair<vector<int>, int> toOriginal(pair<vector<int>, int> path) const;
+
+    /**
+     * @brief The mean of |from - to| over all edges of the relabelled graph: how far apart in memory the ends of an edge are.
+     */
+    double meanEdgeSpan() const;
+
+private:
+    CSRGraph reordered;
+    vector<int> newToOld;
+    vector<int> oldToNew;
+};
+
+#endif // REORDER_H
@@ -0,0 +1,97 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <algorithm>
+#include <cstddef>
+using namespace std;
+
+/**
+ * @brief Counters of what one shortest-path search did, for finding out why a query is slow.
+ *
+ * The searches are templates over a statistics policy: this one counts, NoStats
+ * has the same hooks with empty bodies, so an uninstrumented search compiles
+ * to the same code as before. The public functions take an optional
+ * SearchStats pointer and pick the policy once per query.
+ */
+struct SearchStats {
+    /**
+     * @brief Nodes taken from the queue (or processed in order) and expanded.
+     */
+    long long nodesSettled = 0;
+
+    /**
+     * @brief Edges looked at while relaxing.
+     */
+    long long edgesRelaxed = 0;
+
+    /**
+     * @brief Relaxations that lowered a distance.
+     */
+    long long successfulRelaxations = 0;
+
+    /**
+     * @brief Entries added to the priority queue or bucket queue.
+     */
+    long long queuePushes = 0;
+
+    /**
+     * @brief Entries removed from the queue, stale ones included.
+     */
+    long long queuePops = 0;
+
+    /**
+     * @brief Popped entries skipped because their node had since got a smaller distance.
+     */
+    long long staleEntries = 0;
+
+    /**
+     * @brief Passes over the edges (Bellman-Ford) or 1 for single-pass searches.
+     */
+    long long rounds = 0;
+
+    /**
+     * @brief The largest number of entries the queue held at once.
+     */
+    long long peakQueueSize = 0;
+
+    void onSettle() { nodesSettled++; }
+    void onRelax() { edgesRelaxed++; }
+    void onImprove() { successfulRelaxations++; }
+    void onPush(size_t queueSize) {
+        queuePushes++;
+        peakQueueSize = max(peakQueueSize, static_cast<long long>(queueSize));
+    }
+    void onPop() { queuePops++; }
+    void onStale() { staleEntries++; }
+    void onRound() { rounds++; }
+
+    /**
+     * @brief Adds the counters of another search; the peak queue size becomes the larger of the two.
+     */
+    SearchStats &operator+=(const SearchStats &other) {
+        nodesSettled += other.nodesSettled;
+        edgesRelaxed += other.edgesRelaxed;
+        successfulRelaxations += other.successfulRelaxations;
+        queuePushes += other.queuePushes;
+        queuePops += other.queuePops;
+        staleEntries += other.staleEntries;
+        rounds += other.rounds;
+        peakQueueSize = max(peakQueueSize, other.peakQueueSize);
+        return *this;
+    }
+};
+
+/**
+ * @brief The statistics policy of uninstrumented searches: every hook is empty and compiles away.
+ */
+struct NoStats {
+    void onSettle() {}
+    void onRelax() {}
+    void onImprove() {}
+    void onPush(size_t) {}
+    void onPop() {}
+    void onStale() {}
+    void onRound() {}
+};
+
+#endif // SEARCHSTATS_H
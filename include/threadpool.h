@@ -0,0 +1,81 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/**
+ * @brief A fixed set of worker threads that run parallel loops.
+ *
+ * The threads are started once and sleep between jobs, so algorithms that run
+ * many short parallel rounds (one per bucket or frontier) do not pay for
+ * thread creation each round. The calling thread takes part in every loop as
+ * worker 0, so a pool of size 1 runs everything inline.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @brief Starts the workers.
+     * @param numThreads The total number of threads used by a loop, including the caller;
+     *                   0 or less means one per hardware thread.
+     */
+    explicit ThreadPool(int numThreads = 0);
+
+    /**
+     * @brief Stops and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief The number of threads a loop runs on, including the caller.
+     */
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    /**
+     * @brief Runs body over [0, count) in chunks of grain indices and waits for all of them.
+     *
+     * Chunks are handed out dynamically, so uneven work per index balances itself.
+     * Must not be called from inside a body of the same pool.
+     *
+     * If a body throws, no further chunks are handed out; chunks already running
+     * finish, and the first exception is rethrown here once every worker is idle.
+     *
+     * @param count The number of indices.
+     * @param grain The number of consecutive indices one call of body receives.
+     * @param body Called as body(begin, end, worker) with worker in [0, size()).
+     * @throws Whatever the first throwing call of body threw.
+     */
+    void parallelFor(int count, int grain, const function<void(int, int, int)> &body);
+
+private:
+    void workerLoop(int worker);
+    void runChunks(int worker);
+
+    vector<thread> workers;
+
+    mutex lock;
+    condition_variable wake; // a new job was published (or the pool stops)
+    condition_variable done; // the last worker finished the current job
+    long long generation = 0;
+    bool stopping = false;
+
+    // The current job
+    const function<void(int, int, int)> *job = nullptr;
+    int jobCount = 0;
+    int jobGrain = 1;
+    atomic<int> nextIndex{0};
+    int busyWorkers = 0;
+    exception_ptr failure; // the first exception a body threw, guarded by lock
+};
+
+#endif // THREADPOOL_H
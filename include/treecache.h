@@ -0,0 +1,133 @@
+#ifndef TREECACHE_H
+#define TREECACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "algorithm.h"
+#include "graph.h"
+#include "progress.h"
+#include "searchstats.h"
+using namespace std;
+
+/**
+ * @brief Default memory budget of a ShortestPathTreeCache.
+ */
+const size_t DEFAULT_TREE_CACHE_BYTES = size_t(64) << 20;
+
+/**
+ * @brief Keeps whole shortest-path trees of recently queried sources, so a repeated source costs only its path.
+ *
+ * Trees are keyed by (graph version, source). Setting a graph starts a new
+ * version and drops every tree of the old one; a tree still being computed
+ * for an old version when that happens is not stored. When the trees
+ * exceed the memory budget, the least recently used ones are evicted.
+ *
+ * Trees come from DAGShortestPathTree for topologically ordered graphs, from
+ * DijkstraTree for other graphs with non-negative weights and from
+ * BellmanFordTree otherwise, so the graph must not contain a negative cycle.
+ * All methods may be called from several threads at once; trees are
+ * computed outside the lock.
+ */
+class ShortestPathTreeCache
+{
+public:
+    /**
+     * @brief Creates an empty cache for an empty graph.
+     * @param maxBytes The memory the cached trees may use together.
+     */
+    explicit ShortestPathTreeCache(size_t maxBytes = DEFAULT_TREE_CACHE_BYTES);
+
+    /**
+     * @brief Replaces the graph; every cached tree is invalidated.
+     */
+    void setGraph(CSRGraph graph);
+
+    /**
+     * @brief The number of times setGraph has been called; part of every cache key.
+     */
+    unsigned long long graphVersion() const;
+
+    /**
+     * @brief Answers a query, from the cached tree of source if there is one.
+     *
+     * A hit costs O(path length); a miss computes and caches the tree of source first.
+     *
+     * @param source The source node.
+     * @param target The target node.
+     * @param stats If not null and the tree had to be computed, receives the counters of that search.
+     * @param progress If not null, follows the search and can cancel it, in which case nothing is cached.
+     * @return The shortest path from source to target and its total distance.
+     * @throws Cancelled If progress was cancelled during the search.
+     */
+    pair<vector<int>, int> query(int source, int target, SearchStats *stats = nullptr, Progress *progress = nullptr);
+
+    /**
+     * @brief The shortest-path tree of a source, cached or computed and cached.
+     */
+    shared_ptr<const ShortestPathTree> tree(int source, SearchStats *stats = nullptr, Progress *progress = nullptr);
+
+    /**
+     * @brief Whether the tree of source is cached for the current graph; does not count as a lookup.
+     */
+    bool contains(int source) const;
+
+    /**
+     * @brief Drops every cached tree but keeps the graph and the counters.
+     */
+    void clear();
+
+    /**
+     * @brief Changes the memory budget, evicting trees if the cache is now over it.
+     */
+    void setMaxBytes(size_t maxBytes);
+
+    size_t maxBytes() const;
+
+    /**
+     * @brief Bytes used by the cached trees and their bookkeeping.
+     */
+    size_t memoryBytes() const;
+
+    /**
+     * @brief The number of cached trees.
+     */
+    size_t size() const;
+
+    long long hits() const;
+    long long misses() const;
+    long long evictions() const;
+
+    /**
+     * @brief hits / (hits + misses), 0 before the first lookup.
+     */
+    double hitRate() const;
+
+private:
+    struct Entry {
+        int source;
+        shared_ptr<const ShortestPathTree> tree;
+        size_t bytes;
+    };
+
+    static size_t treeBytes(const ShortestPathTree &tree);
+    void evictOverBudget();
+
+    mutable mutex lock;
+    CSRGraph graph;
+    unsigned long long version = 0;
+
+    list<Entry> entries; // most recently used first
+    unordered_map<int, list<Entry>::iterator> bySource; // trees of the current version only
+    size_t budget;
+    size_t usedBytes = 0;
+
+    long long hitCount = 0;
+    long long missCount = 0;
+    long long evictionCount = 0;
+};
+
+#endif // TREECACHE_H
@@ -0,0 +1,176 @@
+#ifndef TYPEDGRAPH_H
+#define TYPEDGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "graph.h"
+#include "searchstats.h"
+using namespace std;
+
+/**
+ * @brief A CSR graph with the node id and weight types chosen by the user.
+ *
+ * CSRGraph stores every node id, offset and weight as an int. With small
+ * weight ranges, such as the -10..10 of the generated DAGs, an int8_t
+ * weight saves 3 of the 8 bytes per edge, and an int16_t weight 2.
+ * Offsets are 32 bits unless NodeId is 64 bits.
+ *
+ * The class is defined here but compiled ahead of time in typedgraph.cpp
+ * for the instantiations declared extern at the end of this file: int32_t
+ * nodes with int32_t weights (the layout of CSRGraph), and uint32_t nodes
+ * with int8_t, int16_t, int32_t or float weights. Other types need an
+ * explicit instantiation there.
+ *
+ * @tparam NodeId An integer type for node ids.
+ * @tparam Weight An integer or floating-point type for edge weights.
+ */
+template<typename NodeId, typename Weight>
+class BasicCSRGraph
+{
+    static_assert(is_integral<NodeId>::value, "node ids must be integers");
+    static_assert(is_arithmetic<Weight>::value, "weights must be numbers");
+
+public:
+    using NodeType = NodeId;
+    using WeightType = Weight;
+    using EdgeIndex = conditional_t<(sizeof(NodeId) > 4), uint64_t, uint32_t>;
+
+    /**
+     * @brief The predecessor of the source and of unreachable nodes: -1, or the largest id for unsigned ids.
+     */
+    static constexpr NodeId NO_NODE = static_cast<NodeId>(-1);
+
+    BasicCSRGraph() = default;
+
+    /**
+     * @brief Builds a graph from already laid out arrays.
+     * @param offsets num_nodes + 1 edge offsets; offsets[0] must be 0.
+     * @param targets The destination node of every edge.
+     * @param weights The weight of every edge.
+     * @throws invalid_argument If the arrays do not form a graph.
+     */
+    BasicCSRGraph(vector<EdgeIndex> offsets, vector<NodeId> targets, vector<Weight> weights);
+
+    /**
+     * @brief Converts an int graph, checking that every node id and weight fits the narrower types.
+     * @param graph The graph to convert.
+     * @return The same graph with NodeId ids and Weight weights.
+     * @throws out_of_range If a node id, edge offset or weight cannot be represented.
+     */
+    static BasicCSRGraph fromCSR(const CSRGraph &graph);
+
+    /**
+     * @brief Whether fromCSR can convert the graph, i.e. all its ids and weights fit.
+     */
+    static bool fits(const CSRGraph &graph);
+
+    NodeId numNodes() const { return static_cast<NodeId>(offsets.size() - 1); }
+    EdgeIndex numEdges() const { return static_cast<EdgeIndex>(targets.size()); }
+
+    EdgeIndex edgesBegin(NodeId node) const { return offsets[node]; }
+    EdgeIndex edgesEnd(NodeId node) const { return offsets[node + 1]; }
+
+    NodeId target(EdgeIndex edge) const { return targets[edge]; }
+    Weight weight(EdgeIndex edge) const { return weights[edge]; }
+
+    Weight minWeight() const { return minEdgeWeight; }
+    Weight maxWeight() const { return maxEdgeWeight; }
+
+    /**
+     * @brief The bytes taken by the offset, target and weight arrays.
+     */
+    size_t memoryBytes() const {
+        return offsets.size() * sizeof(EdgeIndex) + targets.size() * sizeof(NodeId) + weights.size() * sizeof(Weight);
+    }
+
+private:
+    vector<EdgeIndex> offsets = vector<EdgeIndex>(1, 0);
+    vector<NodeId> targets;
+    vector<Weight> weights;
+    Weight minEdgeWeight = 0;
+    Weight maxEdgeWeight = 0;
+};
+
+/**
+ * @brief Distances and predecessors of every node from one source, with the distance type chosen by the user.
+ *
+ * @tparam NodeId The node id type of the graph.
+ * @tparam Distance The type distances are accumulated in.
+ */
+template<typename NodeId, typename Distance>
+struct BasicShortestPathTree {
+    /**
+     * @brief The distance of unreachable nodes: the largest Distance, or infinity for floating point.
+     */
+    static constexpr Distance unreachable() {
+        return numeric_limits<Distance>::has_infinity ? numeric_limits<Distance>::infinity() : numeric_limits<Distance>::max();
+    }
+
+    /**
+     * @brief distance[v] from the source, unreachable() if v is unreachable.
+     */
+    vector<Distance> distance;
+
+    /**
+     * @brief The node before v on its shortest path, BasicCSRGraph::NO_NODE for the source and unreachable nodes.
+     */
+    vector<NodeId> predecessor;
+
+    /**
+     * @brief True if a path length did not fit in Distance.
+     *
+     * Integer sums are saturated: a path that would overflow gets the largest
+     * finite distance (unreachable() - 1), or the smallest one if it would
+     * underflow, instead of wrapping around.
+     */
+    bool saturated = false;
+};
+
+/**
+ * @brief Dijkstra's algorithm on a typed graph, computing the shortest-path tree of every reachable node.
+ *
+ * Weights are widened to Distance before they are added, and integer sums
+ * saturate instead of overflowing, so a wide Distance (such as int64_t over
+ * int8_t weights) stays exact on long paths.
+ *
+ * @tparam Distance The type distances are accumulated in; it must hold every weight.
+ * @param graph The graph; weights must be non-negative.
+ * @param source The node to start from.
+ * @param stats If given, the search counters are added to it.
+ * @return The tree of every node reachable from the source.
+ */
+template<typename Distance, typename NodeId, typename Weight>
+BasicShortestPathTree<NodeId, Distance> DijkstraTree(const BasicCSRGraph<NodeId, Weight> &graph,
+                                                     NodeId source,
+                                                     SearchStats *stats = nullptr);
+
+/**
+ * @brief Bellman-Ford on a typed graph, computing the shortest-path tree of every reachable node.
+ *
+ * Accumulates like the typed DijkstraTree. Negative weights are allowed;
+ * with a negative cycle reachable from the source the distances are not
+ * shortest ones, as with BellmanFordTree on a CSRGraph.
+ *
+ * @tparam Distance The type distances are accumulated in; it must hold every weight.
+ * @param graph The graph.
+ * @param source The node to start from.
+ * @param stats If given, the search counters are added to it.
+ * @return The tree of every node reachable from the source.
+ */
+template<typename Distance, typename NodeId, typename Weight>
+BasicShortestPathTree<NodeId, Distance> BellmanFordTree(const BasicCSRGraph<NodeId, Weight> &graph,
+                                                        NodeId source,
+                                                        SearchStats *stats = nullptr);
+
+// Compiled in typedgraph.cpp, with DijkstraTree and BellmanFordTree for int32_t and int64_t distances
+// over the integer weights and for float and double distances over float weights
+extern template class BasicCSRGraph<int32_t, int32_t>;
+extern template class BasicCSRGraph<uint32_t, int8_t>;
+extern template class BasicCSRGraph<uint32_t, int16_t>;
+extern template class BasicCSRGraph<uint32_t, int32_t>;
+extern template class BasicCSRGraph<uint32_t, float>;
+
+#endif // TYPEDGRAPH_H
@@ -0,0 +1,84 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <limits>
+#include <utility>
+#include <vector>
+using namespace std;
+
+/**
+ * @brief Search state that is kept between queries instead of being allocated for each one.
+ *
+ * Every node label carries the version of the query that wrote it; a label
+ * from an older version reads as unreached. Starting a query just bumps the
+ * version, so a search that settles a few hundred nodes of a 1M-node graph
+ * only touches those nodes' labels. The heap and bucket buffers keep their
+ * capacity too. One workspace serves one query at a time; give every thread
+ * its own.
+ */
+class QueryWorkspace
+{
+public:
+    /**
+     * @brief Creates a workspace; it grows on demand, num_nodes only pre-sizes it.
+     */
+    explicit QueryWorkspace(int num_nodes = 0);
+
+    /**
+     * @brief Starts a new query on a graph with num_nodes nodes and invalidates every label.
+     *
+     * O(1) unless the graph is larger than any before or the version counter wraps around.
+     */
+    void begin(int num_nodes);
+
+    /**
+     * @brief The distance of a node in the current query, numeric_limits<int>::max() if unreached.
+     */
+    int distanceOf(int node) const {
+        return labels[node].version == version ? labels[node].distance : numeric_limits<int>::max();
+    }
+
+    /**
+     * @brief The predecessor of a node in the current query, -1 if none.
+     */
+    int predecessorOf(int node) const {
+        return labels[node].version == version ? labels[node].predecessor : -1;
+    }
+
+    /**
+     * @brief Sets the distance and predecessor of a node for the current query.
+     */
+    void set(int node, int distance, int predecessor) {
+        labels[node] = {distance, predecessor, version};
+    }
+
+    /**
+     * @brief Changes only the predecessor of a node that already has a label in the current query.
+     */
+    void setPredecessor(int node, int predecessor) { labels[node].predecessor = predecessor; }
+
+    /**
+     * @brief Heap storage for (distance, node) entries; empty at the start of a query.
+     */
+    vector<pair<int, int>> &heap() { return heapBuffer; }
+
+    /**
+     * @brief Bucket queue storage; every bucket is empty at the start of a query.
+     */
+    vector<vector<int>> &buckets() { return bucketBuffer; }
+
+private:
+    // One record per node so a label costs one cache line access
+    struct Label {
+        int distance;
+        int predecessor;
+        unsigned version;
+    };
+
+    vector<Label> labels;
+    unsigned version = 0;
+    vector<pair<int, int>> heapBuffer;
+    vector<vector<int>> bucketBuffer;
+};
+
+#endif // WORKSPACE_H
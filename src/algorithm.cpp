@@ -1,77 +1,205 @@
 #include "../include/algorithm.h"
+#include "../include/threadpool.h"
 #include <algorithm>
 #include <iostream>
 #include <limits>
 #include <queue>
 #include <random>
-#include <unordered_set>
 using namespace std;
 
+// Nodes per chunk of a parallel generation loop
+static const int GENERATOR_GRAIN = 4096;
+
+// A SplitMix64 stream per node. Its start state is derived from (seed, node) in O(1), so each
+// node draws from its own sequence and the output does not depend on which thread handles it
+class NodeRandom
+{
+public:
+    NodeRandom(const unsigned long long seed, const unsigned long long node)
+        : state(seed ^ (node * 0xD1B54A32D192ED03ull))
+    {
+        next(); // spread nearby seeds before the first real draw
+    }
+
+    unsigned long long next() {
+        unsigned long long z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound), bound <= 2^32, by multiply-shift (no division, no rejection loop)
+    long long below(const long long bound) {
+        return static_cast<long long>(((next() >> 32) * static_cast<unsigned long long>(bound)) >> 32);
+    }
+
+    int between(const int low, const int high) {
+        return low + static_cast<int>(below(static_cast<long long>(high) - low + 1));
+    }
+
+    // Uniform in [0, 1)
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+    unsigned long long state;
+};
+
+// Seed for the unseeded generators, which produce a new graph on every call
+static unsigned long long randomSeed()
+{
+    random_device rd;
+    return (static_cast<unsigned long long>(rd()) << 32) ^ rd();
+}
+
+// Draw count distinct targets from [low, high) that are not in `exclude` (sorted), appending them
+// to `chosen` in draw order. Sparse draws reject duplicates against a small sorted copy; when
+// count is close to the range size, a partial shuffle of the free candidates is used instead
+static void sampleDistinct(NodeRandom &random,
+                           const int low,
+                           const int high,
+                           const int count,
+                           const vector<int> &exclude,
+                           vector<int> &chosen,
+                           vector<int> &scratch)
+{
+    const long long range = static_cast<long long>(high) - low;
+    if (count <= 0) {
+        return;
+    }
+
+    if (2LL * (count + static_cast<long long>(exclude.size())) >= range) {
+        scratch.clear();
+        for (int v = low; v < high; v++) {
+            if (!binary_search(exclude.begin(), exclude.end(), v)) {
+                scratch.push_back(v);
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            int j = i + static_cast<int>(random.below(scratch.size() - i));
+            swap(scratch[i], scratch[j]);
+            chosen.push_back(scratch[i]);
+        }
+        return;
+    }
+
+    scratch.assign(exclude.begin(), exclude.end()); // sorted set of everything already taken
+    while (count > static_cast<int>(scratch.size() - exclude.size())) {
+        int v = low + static_cast<int>(random.below(range));
+        auto at = lower_bound(scratch.begin(), scratch.end(), v);
+        if (at == scratch.end() || *at != v) {
+            scratch.insert(at, v);
+            chosen.push_back(v);
+        }
+    }
+}
+
 // Generate a Directed graph with weighted edges
 vector<vector<Edge>> generateDirectedGraph(const int num_nodes,
                                            const int avg_degree,
                                            const int min_weight,
                                            const int max_weight)
 {
-    // use adjacency list to represent the graph
-    vector<vector<Edge>> adjacencyList(num_nodes);
+    return generateDirectedGraphCSR(num_nodes, avg_degree, min_weight, max_weight).toAdjacencyList();
+}
 
-    // use set to store unique edges
-    unordered_set<long long> edgeSet;
+CSRGraph generateDirectedGraphCSR(const int num_nodes,
+                                  const int avg_degree,
+                                  const int min_weight,
+                                  const int max_weight)
+{
+    return generateDirectedGraphCSR(num_nodes, avg_degree, min_weight, max_weight, randomSeed());
+}
 
-    srand(time(nullptr)); // seed the random number generator
+// Whether a generator should skip the rest of its chunks because the caller gave up on the graph;
+// the pool does not carry exceptions, so the generator throws once the parallel loop is over
+static bool stopRequested(const Progress *progress)
+{
+    return progress && progress->cancelled();
+}
 
-    // Iterate through each node to assign outgoing edges
-    for (int i = 0; i < num_nodes; i++) {
-        // number of outgoing edges for the current node
-        int degree = avg_degree;
-
-        // keep assigning outgoing edges for the current node...
-        while (degree > 0) {
-            int from_node = i;                // current node
-            int to_node = rand() % num_nodes; // randomly select a target node from all nodes
-            int weight;                       // weight for current edge
-            long long edge_hash;              // for identify the current edge
-
-            // avoid self-loops
-            if (from_node == to_node) {
-                continue;
-            }
+// Generate a Directed graph with weighted edges, written straight into CSR arrays.
+// Every node gets exactly avg_degree distinct targets other than itself (fewer only if the
+// graph is too small to have that many), drawn from the node's own random stream
+CSRGraph generateDirectedGraphCSR(const int num_nodes,
+                                  const int avg_degree,
+                                  const int min_weight,
+                                  const int max_weight,
+                                  const unsigned long long seed,
+                                  const int num_threads,
+                                  Progress *progress)
+{
+    const int degree = max(0, min(avg_degree, num_nodes - 1));
+    if (progress) {
+        progress->start(num_nodes);
+    }
 
-            // Randomly generate a weight for the current outgoing edge
-            weight = min_weight + rand() % (max_weight - min_weight + 1);
+    // the degree is fixed, so the offsets are known upfront and every node writes its own slots
+    vector<int> offsets(num_nodes + 1);
+    for (int i = 0; i <= num_nodes; i++) {
+        offsets[i] = i * degree;
+    }
+    vector<int> targets(static_cast<size_t>(num_nodes) * degree);
+    vector<int> weights(static_cast<size_t>(num_nodes) * degree);
 
-            // assign a unique number for the current edge
-            edge_hash = static_cast<long long>(from_node) * num_nodes + to_node;
+    ThreadPool pool(num_threads);
+    pool.parallelFor(num_nodes, GENERATOR_GRAIN, [&](int begin, int end, int) {
+        if (stopRequested(progress)) {
+            return;
+        }
+        const vector<int> none;
+        vector<int> chosen, scratch;
+        for (int from_node = begin; from_node < end; from_node++) {
+            NodeRandom random(seed, from_node);
 
-            // Check whether the current edge is unique
-            if (edgeSet.find(edge_hash) == edgeSet.end()) {
-                // push the target node and corresponding weight to the adjacent list
-                adjacencyList[from_node].push_back({to_node, weight});
-                // insert the unique edge to the set to avoid potential duplicates later
-                edgeSet.insert(edge_hash);
-                degree = degree - 1; // finish assigning one outgoing edge for the current node
+            // draw from the other num_nodes - 1 nodes: skipping from_node avoids self-loops
+            chosen.clear();
+            sampleDistinct(random, 0, num_nodes - 1, degree, none, chosen, scratch);
+            for (int i = 0; i < degree; i++) {
+                int to_node = chosen[i] >= from_node ? chosen[i] + 1 : chosen[i];
+                targets[offsets[from_node] + i] = to_node;
+                weights[offsets[from_node] + i] = random.between(min_weight, max_weight);
             }
         }
+        if (progress) {
+            progress->advance(end - begin);
+        }
+    });
+    if (progress) {
+        progress->throwIfCancelled();
     }
-    return adjacencyList;
+    return CSRGraph(std::move(offsets), std::move(targets), std::move(weights));
 }
 
 // Generates a Directed Acyclic Graph (DA Graph) with weighted edges
-// Ensures no duplicate edges and maintains acyclic property (from < to)
 vector<vector<Edge>> generateDAGraph(int num_nodes, int avg_degree, int min_weight, int max_weight)
 {
-    vector<vector<Edge>> adjacencyList(num_nodes); // Representation of the graph
+    return generateDAGraphCSR(num_nodes, avg_degree, min_weight, max_weight).toAdjacencyList();
+}
 
-    // Random number generator
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<int> weight_dist(min_weight, max_weight);
-    uniform_int_distribution<int> node_dist(0, num_nodes - 1);
+CSRGraph generateDAGraphCSR(int num_nodes, int avg_degree, int min_weight, int max_weight)
+{
+    return generateDAGraphCSR(num_nodes, avg_degree, min_weight, max_weight, randomSeed());
+}
+
+// Generates a Directed Acyclic Graph (DA Graph) with weighted edges
+// Ensures no duplicate edges and maintains acyclic property (from < to)
+CSRGraph generateDAGraphCSR(const int num_nodes,
+                            const int avg_degree,
+                            const int min_weight,
+                            const int max_weight,
+                            const unsigned long long seed,
+                            const int num_threads,
+                            Progress *progress)
+{
+    if (progress) {
+        progress->start(num_nodes);
+    }
 
     // Small Graph (Nodes <=10)
     if (num_nodes <= 10) {
+        vector<pair<int, Edge>> edges; // (from, edge) pairs, grouped into CSR at the end
         vector<pair<int, int>> possibleEdges; // Stores all valid edges (from < to)
+        NodeRandom random(seed, 0);
 
         // Generate all possible valid edges where from < to
         for (int from = 0; from < num_nodes; ++from) {
@@ -80,183 +208,889 @@ vector<vector<Edge>> generateDAGraph(int num_nodes, int avg_degree, int min_weig
             }
         }
 
-        // Shuffle the edge list to randomize edge selection
-        shuffle(possibleEdges.begin(), possibleEdges.end(), gen);
-
         // Limit the number of edges
         int maxEdges = possibleEdges.size();
         int desiredEdges = min(avg_degree * num_nodes, maxEdges);
 
-        // Select desired number of edges and assign random weights
+        // Select desired number of edges (a partial shuffle) and assign random weights
         for (int i = 0; i < desiredEdges; ++i) {
+            swap(possibleEdges[i], possibleEdges[i + random.below(maxEdges - i)]);
             int from = possibleEdges[i].first;
             int to = possibleEdges[i].second;
-            int weight = weight_dist(gen);
-            adjacencyList[from].push_back({to, weight});
+            int weight = random.between(min_weight, max_weight);
+            edges.push_back({from, {to, weight}});
         }
 
-        return adjacencyList;
+        return CSRGraph::fromEdgeList(num_nodes, edges, true);
     }
 
     // Large Graph (nodes>10)
-    unordered_set<long long> edgeSet; // Store unique edges
+    ThreadPool pool(num_threads);
 
-    // Ensure each node (except the first one) has at least one incoming edge
+    // Ensure each node (except the first one) has at least one incoming edge: node i draws its
+    // parent from [0, i) and the weight of that edge as the first values of its stream
+    vector<int> parent(num_nodes, -1);
+    vector<int> parentWeight(num_nodes, 0);
+    pool.parallelFor(num_nodes - 1, GENERATOR_GRAIN, [&](int begin, int end, int) {
+        if (stopRequested(progress)) {
+            return;
+        }
+        for (int i = begin + 1; i <= end; i++) {
+            NodeRandom random(seed, i);
+            parent[i] = static_cast<int>(random.below(i));
+            parentWeight[i] = random.between(min_weight, max_weight);
+        }
+    });
+    if (progress) {
+        progress->throwIfCancelled();
+    }
+
+    // Children of every node, grouped by a counting sort (ascending child id within a parent)
+    vector<int> childOffsets(num_nodes + 1, 0);
     for (int i = 1; i < num_nodes; i++) {
-        uniform_int_distribution<int> from_dist(0, i - 1);
-        int fromNode = from_dist(gen);
-        int toNode = i; // Ensure toNode > fromNode
-        int weight = weight_dist(gen);
-        long long edge_hash = static_cast<long long>(fromNode) * num_nodes
-                              + toNode; // Unique identifier for the edge
-
-        // Add the edge if it does not already exist
-        if (edgeSet.find(edge_hash) == edgeSet.end()) {
-            adjacencyList[fromNode].push_back({toNode, weight});
-            edgeSet.insert(edge_hash);
-        }
-    }
-
-    // Add additional edges to achieve the desired average degree
-    int numEdges = avg_degree * num_nodes; // Total desired edges = avg_degree * num_nodes
-    while (numEdges > 0) {
-        int fromNode = node_dist(gen);
-        int toNode = node_dist(gen);
-
-        // Ensure the edge maintains the acyclic property (fromNode < toNode)
-        if (fromNode < toNode) {
-            long long edge_hash = static_cast<long long>(fromNode) * num_nodes + toNode;
-            if (edgeSet.find(edge_hash) == edgeSet.end()) { // Avoid duplicates
-                int weight = weight_dist(gen);
-                adjacencyList[fromNode].push_back({toNode, weight});
-                edgeSet.insert(edge_hash);
-                numEdges--;
+        childOffsets[parent[i] + 1]++;
+    }
+    for (int i = 0; i < num_nodes; i++) {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+    vector<int> children(max(0, num_nodes - 1));
+    {
+        vector<int> cursor(childOffsets.begin(), childOffsets.end() - 1);
+        for (int i = 1; i < num_nodes; i++) {
+            children[cursor[parent[i]]++] = i;
+        }
+    }
+
+    // Spread avg_degree * num_nodes additional edges over the sources in proportion to the
+    // number of valid pairs (from < to) each one has, as uniform pair sampling would, rounding
+    // stochastically with the node's stream. Sources near the end may run out of targets
+    const double totalPairs = 0.5 * num_nodes * (num_nodes - 1.0);
+    const double extraEdges = static_cast<double>(avg_degree) * num_nodes;
+    vector<int> extra(num_nodes);
+    pool.parallelFor(num_nodes, GENERATOR_GRAIN, [&](int begin, int end, int) {
+        if (stopRequested(progress)) {
+            return;
+        }
+        for (int from_node = begin; from_node < end; from_node++) {
+            NodeRandom random(seed ^ 0x5DEECE66Dull, from_node);
+            const int candidates = num_nodes - 1 - from_node;
+            double expected = extraEdges * candidates / totalPairs;
+            int count = static_cast<int>(expected);
+            if (random.unit() < expected - count) {
+                count++;
+            }
+            int numChildren = childOffsets[from_node + 1] - childOffsets[from_node];
+            extra[from_node] = min(count, candidates - numChildren);
+        }
+    });
+    if (progress) {
+        progress->throwIfCancelled();
+    }
+
+    vector<int> offsets(num_nodes + 1, 0);
+    for (int i = 0; i < num_nodes; i++) {
+        offsets[i + 1] = offsets[i] + (childOffsets[i + 1] - childOffsets[i]) + extra[i];
+    }
+    vector<int> targets(offsets[num_nodes]);
+    vector<int> weights(offsets[num_nodes]);
+
+    // Every source writes its tree edges, then draws its additional targets directly from
+    // (from_node, num_nodes), skipping its children so no edge is duplicated
+    pool.parallelFor(num_nodes, GENERATOR_GRAIN, [&](int begin, int end, int) {
+        if (stopRequested(progress)) {
+            return;
+        }
+        vector<int> own, chosen, scratch;
+        for (int from_node = begin; from_node < end; from_node++) {
+            NodeRandom random(seed ^ 0x2545F4914F6CDD1Dull, from_node);
+            int slot = offsets[from_node];
+
+            own.assign(children.begin() + childOffsets[from_node], children.begin() + childOffsets[from_node + 1]);
+            for (int child : own) {
+                targets[slot] = child;
+                weights[slot] = parentWeight[child];
+                slot++;
             }
+
+            chosen.clear();
+            sampleDistinct(random, from_node + 1, num_nodes, extra[from_node], own, chosen, scratch);
+            for (int to_node : chosen) {
+                targets[slot] = to_node;
+                weights[slot] = random.between(min_weight, max_weight);
+                slot++;
+            }
+        }
+        if (progress) {
+            progress->advance(end - begin);
         }
+    });
+    if (progress) {
+        progress->throwIfCancelled();
     }
-    return adjacencyList;
+    return CSRGraph(std::move(offsets), std::move(targets), std::move(weights), true);
 }
 
-// Dijkstra's Algorithm
-pair<vector<int>, int> Dijkstra(const int num_nodes,
-                                const int source,
-                                const int target,
-                                const vector<vector<Edge>> &adjacencyList)
+// Visit every outgoing edge of a node stored in an adjacency list
+template<typename Visitor>
+static inline void forEachEdge(const vector<vector<Edge>> &adjacencyList, int node, Visitor &&visit)
 {
-    // vector for updating distance
-    vector<int> distance(num_nodes, numeric_limits<int>::max()); // initial distances: infinite
-    // vector for updating predecessor
-    vector<int> predecessor(num_nodes, -1); // initial predecessor: -1
+    for (const Edge &edge : adjacencyList[node]) {
+        visit(edge.toNode, edge.weight);
+    }
+}
+
+// Visit every outgoing edge of a node stored in a CSR graph
+template<typename Visitor>
+static inline void forEachEdge(const CSRGraph &graph, int node, Visitor &&visit)
+{
+    graph.forEachEdge(node, visit);
+}
+
+// Visit every outgoing edge of a node stored in a compressed graph, decoding them on the way
+template<typename Visitor>
+static inline void forEachEdge(const CompressedGraph &graph, int node, Visitor &&visit)
+{
+    graph.forEachEdge(node, visit);
+}
+
+// Node labels kept in two per-query vectors, sized and initialized by the caller.
+// QueryWorkspace offers the same interface with versioned labels that outlive the query.
+class ArrayLabels
+{
+public:
+    ArrayLabels(vector<int> &distance, vector<int> &predecessor)
+        : distance(distance)
+        , predecessor(predecessor)
+    {}
+
+    int distanceOf(int node) const { return distance[node]; }
+    int predecessorOf(int node) const { return predecessor[node]; }
+    void set(int node, int newDistance, int newPredecessor) {
+        distance[node] = newDistance;
+        predecessor[node] = newPredecessor;
+    }
+    void setPredecessor(int node, int newPredecessor) { predecessor[node] = newPredecessor; }
+
+private:
+    vector<int> &distance;
+    vector<int> &predecessor;
+};
+
+// Walk the predecessor chain back from the target and return the path with its distance
+static pair<vector<int>, int> reconstructPath(const int target,
+                                              const vector<int> &distance,
+                                              const vector<int> &predecessor)
+{
+    vector<int> finalPath;
+
+    // if the target node has not been visited, which means that it is unreachable
+    if (distance[target] == numeric_limits<int>::max()) {
+        return {finalPath, distance[target]};
+    }
 
-    // min-heap priority queue
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+    // use predecessor to track the path from the target node to source node
+    for (int at = target; at != -1; at = predecessor[at]) {
+        finalPath.push_back(at);
+    }
+
+    // reverse the path to get the path from the source node to target source
+    reverse(finalPath.begin(), finalPath.end());
+
+    return {finalPath, distance[target]};
+}
+
+// reconstructPath for labels held in a QueryWorkspace
+static pair<vector<int>, int> reconstructPath(const int target, const QueryWorkspace &workspace)
+{
+    vector<int> finalPath;
+    if (workspace.distanceOf(target) == numeric_limits<int>::max()) {
+        return {finalPath, workspace.distanceOf(target)};
+    }
+    for (int at = target; at != -1; at = workspace.predecessorOf(at)) {
+        finalPath.push_back(at);
+    }
+    reverse(finalPath.begin(), finalPath.end());
+    return {finalPath, workspace.distanceOf(target)};
+}
+
+// Dijkstra's Algorithm, shared by every graph representation and label storage.
+// Writes into labels (every node unreached at the start) and stops once the target is
+// settled; pass target = -1 to settle every reachable node. heap must be empty and is
+// used as the binary heap storage, so a caller can keep its capacity between queries.
+// stats is a SearchStats or NoStats policy.
+template<typename Graph, typename Labels, typename Stats>
+static void dijkstraSearch(const int source,
+                           const int target,
+                           const Graph &graph,
+                           Labels &labels,
+                           vector<pair<int, int>> &heap,
+                           Stats &stats)
+{
+    // min-heap priority queue, kept in heap with the standard heap algorithms
+    const greater<> heapOrder;
 
-    distance[source] = 0; // source node has a distance of 0
-    pq.emplace(0, source);
+    labels.set(source, 0, -1); // source node has a distance of 0
+    heap.emplace_back(0, source);
+    stats.onRound();
+    stats.onPush(heap.size());
 
-    while (!pq.empty()) {
+    while (!heap.empty()) {
         // pull the top element from the priority queue
-        pair<int, int> top_node = pq.top();
+        pop_heap(heap.begin(), heap.end(), heapOrder);
+        pair<int, int> top_node = heap.back();
+        heap.pop_back();
+        stats.onPop();
         int currentDist = top_node.first;
         int from_node = top_node.second;
-        pq.pop();
 
         // early termination if the target node is reached
         if (from_node == target){
+            stats.onSettle();
             break;
         }
 
         // if the distance found before is shorter than the current distance
-        if (currentDist > distance[from_node]) {
+        if (currentDist > labels.distanceOf(from_node)) {
+            stats.onStale();
             continue;
         }
+        stats.onSettle();
 
         // Explore all neighbors of the current node
-        for (auto &edge : adjacencyList[from_node]) {
-            int to_node = edge.toNode;
-            int weight = edge.weight;
-
+        forEachEdge(graph, from_node, [&](int to_node, int weight) {
+            stats.onRelax();
             // Relaxation
-            if (distance[from_node] + weight < distance[to_node]) {
-                // update the distance
-                distance[to_node] = distance[from_node] + weight;
-                // update the predecessor
-                predecessor[to_node] = from_node;
+            if (currentDist + weight < labels.distanceOf(to_node)) {
+                // update the distance and the predecessor
+                labels.set(to_node, currentDist + weight, from_node);
+                stats.onImprove();
 
-                pq.emplace(distance[to_node], to_node);
+                heap.emplace_back(currentDist + weight, to_node);
+                push_heap(heap.begin(), heap.end(), heapOrder);
+                stats.onPush(heap.size());
             }
+        });
+    }
+}
+
+// Runs search(policy) with SearchStats if stats is given and with NoStats otherwise,
+// so the uninstrumented instantiation of every search carries no counting code
+template<typename Search>
+static auto withStats(SearchStats *stats, Search &&search)
+{
+    if (stats) {
+        return search(*stats);
+    }
+    NoStats none;
+    return search(none);
+}
+
+// Settled nodes between two progress reports (and cancellation checks) of a tracked search
+static const int PROGRESS_INTERVAL = 4096;
+
+// A statistics policy that forwards every hook to another one and also reports settled nodes
+// to a Progress, throwing Cancelled at the next report after the search was cancelled
+template<typename Stats>
+class ProgressStats
+{
+public:
+    ProgressStats(Stats &inner, Progress &progress) : inner(inner), progress(progress) {}
+    ~ProgressStats() { progress.advance(pending); }
+
+    void onSettle() {
+        inner.onSettle();
+        if (++pending == PROGRESS_INTERVAL) {
+            report();
         }
     }
+    void onRelax() { inner.onRelax(); }
+    void onImprove() { inner.onImprove(); }
+    void onPush(size_t queueSize) { inner.onPush(queueSize); }
+    void onPop() { inner.onPop(); }
+    void onStale() { inner.onStale(); }
+    void onRound() {
+        inner.onRound();
+        report();
+    }
+
+private:
+    void report() {
+        progress.advance(pending);
+        pending = 0;
+        progress.throwIfCancelled();
+    }
+
+    Stats &inner;
+    Progress &progress;
+    int pending = 0;
+};
+
+// withStats, with the policy wrapped in ProgressStats if progress is given
+template<typename Search>
+static auto withProgress(SearchStats *stats, Progress *progress, Search &&search)
+{
+    return withStats(stats, [&](auto &policy) {
+        if (progress) {
+            ProgressStats<remove_reference_t<decltype(policy)>> tracked(policy, *progress);
+            return search(tracked);
+        }
+        return search(policy);
+    });
+}
+
+template<typename Graph, typename Stats>
+static pair<vector<int>, int> dijkstraImpl(const int num_nodes,
+                                           const int source,
+                                           const int target,
+                                           const Graph &graph,
+                                           Stats &stats)
+{
+    // vector for updating distance
+    vector<int> distance(num_nodes, numeric_limits<int>::max()); // initial distances: infinite
+    // vector for updating predecessor
+    vector<int> predecessor(num_nodes, -1); // initial predecessor: -1
+
+    ArrayLabels labels(distance, predecessor);
+    vector<pair<int, int>> heap;
+    dijkstraSearch(source, target, graph, labels, heap, stats);
+    return reconstructPath(target, distance, predecessor);
+}
+
+// Dijkstra's Algorithm with a circular bucket queue (Dial's algorithm).
+// Same contract as dijkstraSearch, with buckets (all empty) in place of the heap;
+// weights must be non-negative.
+template<typename Labels, typename Stats>
+static void bucketSearch(const int source,
+                         const int target,
+                         const CSRGraph &graph,
+                         Labels &labels,
+                         vector<vector<int>> &buckets,
+                         Stats &stats)
+{
+    // every queued distance lies in [current, current + maxWeight], so maxWeight + 1 buckets suffice
+    const int num_buckets = max(graph.maxWeight(), 0) + 1;
+    if (static_cast<int>(buckets.size()) < num_buckets) {
+        buckets.resize(num_buckets);
+    }
+    long long queued = 0; // number of entries (including stale ones) left in the buckets
+
+    labels.set(source, 0, -1);
+    buckets[0].push_back(source);
+    queued++;
+    stats.onRound();
+    stats.onPush(queued);
+
+    bool targetReached = false;
+    for (int currentDist = 0; queued > 0 && !targetReached; currentDist++) {
+        vector<int> &bucket = buckets[currentDist % num_buckets];
+
+        while (!bucket.empty()) {
+            int from_node = bucket.back();
+            bucket.pop_back();
+            queued--;
+            stats.onPop();
+
+            // stale entry: the node was moved to a smaller distance after being queued here
+            if (labels.distanceOf(from_node) != currentDist) {
+                stats.onStale();
+                continue;
+            }
+            stats.onSettle();
+
+            // early termination if the target node is reached
+            if (from_node == target) {
+                targetReached = true;
+                break;
+            }
+
+            graph.forEachEdge(from_node, [&](int to_node, int weight) {
+                int newDist = currentDist + weight;
+                stats.onRelax();
+
+                if (newDist < labels.distanceOf(to_node)) {
+                    labels.set(to_node, newDist, from_node);
+                    buckets[newDist % num_buckets].push_back(to_node);
+                    queued++;
+                    stats.onImprove();
+                    stats.onPush(queued);
+                } else if (newDist == labels.distanceOf(to_node) && weight > 0) {
+                    // The heap version keeps the predecessor that was settled first, i.e. the
+                    // one with the smallest (distance, id). Nodes inside a bucket are popped in
+                    // arbitrary order, so apply that rule explicitly to get the same path.
+                    // (Zero-weight edges are skipped: from_node could then be a descendant of
+                    // to_node and re-pointing would close a cycle.)
+                    int other = labels.predecessorOf(to_node);
+                    if (other != -1 && (currentDist < labels.distanceOf(other)
+                                        || (currentDist == labels.distanceOf(other) && from_node < other))) {
+                        labels.setPredecessor(to_node, from_node);
+                    }
+                }
+            });
+        }
+    }
+}
+
+// Whether Dijkstra on this graph should use the bucket queue instead of the heap
+static bool prefersBucketQueue(const CSRGraph &graph)
+{
+    return graph.minWeight() >= 1 && graph.maxWeight() <= BUCKET_QUEUE_MAX_WEIGHT;
+}
+
+pair<vector<int>, int> Dijkstra(const int num_nodes,
+                                const int source,
+                                const int target,
+                                const vector<vector<Edge>> &adjacencyList,
+                                SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return dijkstraImpl(num_nodes, source, target, adjacencyList, policy);
+    });
+}
+
+pair<vector<int>, int> Dijkstra(const int num_nodes,
+                                const int source,
+                                const int target,
+                                const CSRGraph &graph,
+                                SearchStats *stats)
+{
+    // small positive integer weights: a bucket queue beats the binary heap
+    if (prefersBucketQueue(graph)) {
+        return DijkstraBucket(num_nodes, source, target, graph, stats);
+    }
+    return DijkstraHeap(num_nodes, source, target, graph, stats);
+}
+
+pair<vector<int>, int> DijkstraHeap(const int num_nodes,
+                                    const int source,
+                                    const int target,
+                                    const CSRGraph &graph,
+                                    SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return dijkstraImpl(num_nodes, source, target, graph, policy);
+    });
+}
+
+pair<vector<int>, int> Dijkstra(const int num_nodes,
+                                const int source,
+                                const int target,
+                                const CompressedGraph &graph,
+                                SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return dijkstraImpl(num_nodes, source, target, graph, policy);
+    });
+}
+
+pair<vector<int>, int> DijkstraBucket(const int num_nodes,
+                                      const int source,
+                                      const int target,
+                                      const CSRGraph &graph,
+                                      SearchStats *stats)
+{
+    vector<int> distance(num_nodes, numeric_limits<int>::max()); // initial distances: infinite
+    vector<int> predecessor(num_nodes, -1);                      // initial predecessor: -1
+
+    ArrayLabels labels(distance, predecessor);
+    vector<vector<int>> buckets;
+    withStats(stats, [&](auto &policy) {
+        bucketSearch(source, target, graph, labels, buckets, policy);
+    });
+    return reconstructPath(target, distance, predecessor);
+}
+
+// Same search as Dijkstra above, with labels, heap and buckets owned by the workspace
+pair<vector<int>, int> Dijkstra(const int num_nodes,
+                                const int source,
+                                const int target,
+                                const CSRGraph &graph,
+                                QueryWorkspace &workspace,
+                                SearchStats *stats)
+{
+    workspace.begin(num_nodes);
+
+    withStats(stats, [&](auto &policy) {
+        if (prefersBucketQueue(graph)) {
+            bucketSearch(source, target, graph, workspace, workspace.buckets(), policy);
+        } else {
+            dijkstraSearch(source, target, graph, workspace, workspace.heap(), policy);
+        }
+    });
+    return reconstructPath(target, workspace);
+}
+
+// Full single-source Dijkstra: no target, every reachable node is settled
+ShortestPathTree DijkstraTree(const CSRGraph &graph, const int source, SearchStats *stats, Progress *progress)
+{
+    ShortestPathTree tree;
+    tree.distance.assign(graph.numNodes(), numeric_limits<int>::max());
+    tree.predecessor.assign(graph.numNodes(), -1);
+    if (progress) {
+        progress->start(graph.numNodes()); // an upper bound: unreachable nodes are never settled
+    }
+
+    ArrayLabels labels(tree.distance, tree.predecessor);
+    withProgress(stats, progress, [&](auto &policy) {
+        if (prefersBucketQueue(graph)) {
+            vector<vector<int>> buckets;
+            bucketSearch(source, -1, graph, labels, buckets, policy);
+        } else {
+            vector<pair<int, int>> heap;
+            dijkstraSearch(source, -1, graph, labels, heap, policy);
+        }
+    });
+    return tree;
+}
+
+pair<vector<int>, int> extractPath(const ShortestPathTree &tree, const int target)
+{
+    return reconstructPath(target, tree.distance, tree.predecessor);
+}
+
+// Bidirectional Dijkstra: forward search from the source, backward search from the target
+template<typename Stats>
+static pair<vector<int>, int> bidirectionalDijkstraImpl(const int num_nodes,
+                                                        const int source,
+                                                        const int target,
+                                                        const CSRGraph &graph,
+                                                        const CSRGraph &reverseGraph,
+                                                        Stats &stats)
+{
+    const int INF = numeric_limits<int>::max();
+    using MinHeap = priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>>;
+
+    // index 0: forward search over graph, index 1: backward search over reverseGraph
+    vector<int> distance[2] = {vector<int>(num_nodes, INF), vector<int>(num_nodes, INF)};
+    vector<int> predecessor[2] = {vector<int>(num_nodes, -1), vector<int>(num_nodes, -1)};
+    const CSRGraph *graphs[2] = {&graph, &reverseGraph};
+    MinHeap pq[2];
+
+    distance[0][source] = 0;
+    distance[1][target] = 0;
+    pq[0].emplace(0, source);
+    pq[1].emplace(0, target);
+    stats.onRound();
+    stats.onPush(1);
+    stats.onPush(2);
+
+    long long best = source == target ? 0 : INF; // length of the best source-target path seen so far
+    int meetingNode = source == target ? source : -1;
+
+    while (!pq[0].empty() && !pq[1].empty()) {
+        // Stopping rule: no path through an unsettled node can beat the best one any more
+        if (static_cast<long long>(pq[0].top().first) + pq[1].top().first >= best) {
+            break;
+        }
+
+        // expand the side whose queue key is smaller
+        const int side = pq[0].top().first <= pq[1].top().first ? 0 : 1;
+        pair<int, int> top_node = pq[side].top();
+        pq[side].pop();
+        stats.onPop();
+        int currentDist = top_node.first;
+        int from_node = top_node.second;
+
+        // skip stale entries
+        if (currentDist > distance[side][from_node]) {
+            stats.onStale();
+            continue;
+        }
+        stats.onSettle();
+
+        graphs[side]->forEachEdge(from_node, [&](int to_node, int weight) {
+            int newDist = currentDist + weight;
+            stats.onRelax();
+            if (newDist < distance[side][to_node]) {
+                distance[side][to_node] = newDist;
+                predecessor[side][to_node] = from_node;
+                pq[side].emplace(newDist, to_node);
+                stats.onImprove();
+                stats.onPush(pq[0].size() + pq[1].size());
+            }
+
+            // the other search already reached to_node: that closes a source-target path
+            if (distance[1 - side][to_node] != INF) {
+                long long through = static_cast<long long>(distance[side][to_node]) + distance[1 - side][to_node];
+                if (through < best) {
+                    best = through;
+                    meetingNode = to_node;
+                }
+            }
+        });
+    }
 
     vector<int> finalPath;
+    if (meetingNode == -1) {
+        return {finalPath, INF};
+    }
 
-    // if the target node has not been visited, which means that it is unreachable
-    if (distance[target] == numeric_limits<int>::max()) {
-        return {finalPath, distance[target]};
+    // source ... meetingNode from the forward predecessors
+    for (int at = meetingNode; at != -1; at = predecessor[0][at]) {
+        finalPath.push_back(at);
     }
+    reverse(finalPath.begin(), finalPath.end());
 
-    // use predecessor to track the path from the target node to source node
-    for (int at = target; at != -1; at = predecessor[at]) {
+    // meetingNode ... target from the backward predecessors, which point towards the target
+    for (int at = predecessor[1][meetingNode]; at != -1; at = predecessor[1][at]) {
         finalPath.push_back(at);
     }
 
-    // reverse the path to get the path from the source node to target source
-    reverse(finalPath.begin(), finalPath.end());
+    return {finalPath, static_cast<int>(best)};
+}
 
-    return {finalPath, distance[target]};
+pair<vector<int>, int> BidirectionalDijkstra(const int num_nodes,
+                                             const int source,
+                                             const int target,
+                                             const CSRGraph &graph,
+                                             const CSRGraph &reverseGraph,
+                                             SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return bidirectionalDijkstraImpl(num_nodes, source, target, graph, reverseGraph, policy);
+    });
 }
 
-// Bellman-Ford Algorithm
-pair<vector<int>, int> BellmanFord(const int num_nodes,
-                                   const int source,
-                                   const int target,
-                                   const vector<vector<Edge>> &adjacencyList)
+// Bellman-Ford Algorithm, shared by every graph representation and label storage.
+// Writes into labels (every node unreached at the start) for every reachable node.
+template<typename Graph, typename Labels, typename Stats>
+static void bellmanFordSearch(const int num_nodes,
+                              const int source,
+                              const Graph &graph,
+                              Labels &labels,
+                              Stats &stats)
 {
-    // Initialize distance vector with "infinity"
-    vector<int> distance(num_nodes, numeric_limits<int>::max());
-    // Initialize predecessor vector to store the shortest path
-    vector<int> predecessor(num_nodes, -1);
-    distance[source] = 0;
+    labels.set(source, 0, -1);
 
     // Relax all edges up to (num_nodes - 1) times
     for (int i = 1; i < num_nodes; i++) {
         bool updated = false;
+        stats.onRound();
         for (int fromNode = 0; fromNode < num_nodes; fromNode++) {
-            if (distance[fromNode] == numeric_limits<int>::max()) {
+            if (labels.distanceOf(fromNode) == numeric_limits<int>::max()) {
                 continue; // Skip unreachable nodes
             }
+            stats.onSettle();
 
             // Traverse all outgoing edges from the current node
-            for (auto &edge : adjacencyList[fromNode]) {
-                int toNode = edge.toNode, weight = edge.weight;
-
+            forEachEdge(graph, fromNode, [&](int toNode, int weight) {
+                stats.onRelax();
                 // Relaxation
-                if (distance[fromNode] + weight < distance[toNode]) {
-                    distance[toNode] = distance[fromNode] + weight;
-                    predecessor[toNode] = fromNode; // Record the path
+                if (labels.distanceOf(fromNode) + weight < labels.distanceOf(toNode)) {
+                    labels.set(toNode, labels.distanceOf(fromNode) + weight, fromNode); // Record the path
+                    stats.onImprove();
                     updated = true;
                 }
-            }
+            });
         }
         // Stop early if no updates in this iteration
         if (!updated)
             break;
     }
+}
 
-    vector<int> path;
+template<typename Graph, typename Stats>
+static pair<vector<int>, int> bellmanFordImpl(const int num_nodes,
+                                              const int source,
+                                              const int target,
+                                              const Graph &graph,
+                                              Stats &stats)
+{
+    // Initialize distance vector with "infinity"
+    vector<int> distance(num_nodes, numeric_limits<int>::max());
+    // Initialize predecessor vector to store the shortest path
+    vector<int> predecessor(num_nodes, -1);
 
-    // If the target node is unreachable, return empty path and "infinity" distance
-    if (distance[target] == numeric_limits<int>::max()) {
-        return {path, distance[target]};
+    ArrayLabels labels(distance, predecessor);
+    bellmanFordSearch(num_nodes, source, graph, labels, stats);
+    return reconstructPath(target, distance, predecessor);
+}
+
+pair<vector<int>, int> BellmanFord(const int num_nodes,
+                                   const int source,
+                                   const int target,
+                                   const vector<vector<Edge>> &adjacencyList,
+                                   SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return bellmanFordImpl(num_nodes, source, target, adjacencyList, policy);
+    });
+}
+
+pair<vector<int>, int> BellmanFord(const int num_nodes,
+                                   const int source,
+                                   const int target,
+                                   const CSRGraph &graph,
+                                   SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return bellmanFordImpl(num_nodes, source, target, graph, policy);
+    });
+}
+
+pair<vector<int>, int> BellmanFord(const int num_nodes,
+                                   const int source,
+                                   const int target,
+                                   const CompressedGraph &graph,
+                                   SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return bellmanFordImpl(num_nodes, source, target, graph, policy);
+    });
+}
+
+pair<vector<int>, int> BellmanFord(const int num_nodes,
+                                   const int source,
+                                   const int target,
+                                   const CSRGraph &graph,
+                                   QueryWorkspace &workspace,
+                                   SearchStats *stats)
+{
+    workspace.begin(num_nodes);
+    withStats(stats, [&](auto &policy) {
+        bellmanFordSearch(num_nodes, source, graph, workspace, policy);
+    });
+    return reconstructPath(target, workspace);
+}
+
+ShortestPathTree BellmanFordTree(const CSRGraph &graph, const int source, SearchStats *stats, Progress *progress)
+{
+    ShortestPathTree tree;
+    tree.distance.assign(graph.numNodes(), numeric_limits<int>::max());
+    tree.predecessor.assign(graph.numNodes(), -1);
+    if (progress) {
+        progress->start(0); // the number of rounds is not known upfront
     }
 
-    // Store the shortest path from target to source using predecessor vector
-    for (int at = target; at != -1; at = predecessor[at]) {
-        path.push_back(at);
+    ArrayLabels labels(tree.distance, tree.predecessor);
+    withProgress(stats, progress, [&](auto &policy) {
+        bellmanFordSearch(graph.numNodes(), source, graph, labels, policy);
+    });
+    return tree;
+}
+
+// Shortest paths on a DAG: relax every edge once, in topological order. Writes into labels
+// (every node unreached at the start) and stops at the target; pass target = -1 for every
+// reachable node. Returns false without touching labels if the graph has a cycle.
+template<typename Graph, typename Labels, typename Stats>
+static bool dagSearch(const int num_nodes,
+                      const int source,
+                      const int target,
+                      const Graph &graph,
+                      const bool topologicallyOrdered,
+                      Labels &labels,
+                      Stats &stats)
+{
+    vector<int> order; // topological order of the nodes (empty: node ids already are one)
+
+    if (!topologicallyOrdered) {
+        // Kahn's algorithm: repeatedly take a node with no remaining incoming edges
+        vector<int> inDegree(num_nodes, 0);
+        for (int node = 0; node < num_nodes; node++) {
+            forEachEdge(graph, node, [&](int toNode, int) { inDegree[toNode]++; });
+        }
+
+        order.reserve(num_nodes);
+        for (int node = 0; node < num_nodes; node++) {
+            if (inDegree[node] == 0) {
+                order.push_back(node);
+            }
+        }
+        for (size_t i = 0; i < order.size(); i++) {
+            forEachEdge(graph, order[i], [&](int toNode, int) {
+                if (--inDegree[toNode] == 0) {
+                    order.push_back(toNode);
+                }
+            });
+        }
+
+        // Some nodes never reached in-degree 0, so the graph has a cycle
+        if (static_cast<int>(order.size()) != num_nodes) {
+            return false;
+        }
+    }
+
+    labels.set(source, 0, -1);
+    stats.onRound();
+
+    // Nodes before the source in the order cannot be reached from it, and nodes after
+    // the target cannot lead back to it, so only the slice between them is relaxed
+    for (int i = topologicallyOrdered ? source : 0; i < num_nodes; i++) {
+        int fromNode = topologicallyOrdered ? i : order[i];
+        if (fromNode == target) {
+            break;
+        }
+        const int fromDistance = labels.distanceOf(fromNode);
+        if (fromDistance == numeric_limits<int>::max()) {
+            continue; // Skip nodes not reachable from the source
+        }
+        stats.onSettle();
+
+        forEachEdge(graph, fromNode, [&](int toNode, int weight) {
+            stats.onRelax();
+            if (fromDistance + weight < labels.distanceOf(toNode)) {
+                labels.set(toNode, fromDistance + weight, fromNode);
+                stats.onImprove();
+            }
+        });
+    }
+    return true;
+}
+
+// Shortest path on a DAG, or Bellman-Ford if the graph turns out to have a cycle
+template<typename Graph, typename Stats>
+static pair<vector<int>, int> dagShortestPathImpl(const int num_nodes,
+                                                  const int source,
+                                                  const int target,
+                                                  const Graph &graph,
+                                                  const bool topologicallyOrdered,
+                                                  Stats &stats)
+{
+    vector<int> distance(num_nodes, numeric_limits<int>::max());
+    vector<int> predecessor(num_nodes, -1);
+    ArrayLabels labels(distance, predecessor);
+    if (!dagSearch(num_nodes, source, target, graph, topologicallyOrdered, labels, stats)) {
+        return bellmanFordImpl(num_nodes, source, target, graph, stats);
     }
+    return reconstructPath(target, distance, predecessor);
+}
+
+pair<vector<int>, int> DAGShortestPath(const int num_nodes,
+                                       const int source,
+                                       const int target,
+                                       const vector<vector<Edge>> &adjacencyList,
+                                       const bool topologicallyOrdered,
+                                       SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return dagShortestPathImpl(num_nodes, source, target, adjacencyList, topologicallyOrdered, policy);
+    });
+}
+
+pair<vector<int>, int> DAGShortestPath(const int num_nodes,
+                                       const int source,
+                                       const int target,
+                                       const CSRGraph &graph,
+                                       SearchStats *stats)
+{
+    return withStats(stats, [&](auto &policy) {
+        return dagShortestPathImpl(num_nodes, source, target, graph, graph.isTopologicallyOrdered(), policy);
+    });
+}
 
-    // Reverse the path to get it from source to target
-    reverse(path.begin(), path.end());
+ShortestPathTree DAGShortestPathTree(const CSRGraph &graph, const int source, SearchStats *stats, Progress *progress)
+{
+    ShortestPathTree tree;
+    tree.distance.assign(graph.numNodes(), numeric_limits<int>::max());
+    tree.predecessor.assign(graph.numNodes(), -1);
+    if (progress) {
+        progress->start(graph.numNodes()); // an upper bound: unreachable nodes are never settled
+    }
 
-    return {path, distance[target]};
+    ArrayLabels labels(tree.distance, tree.predecessor);
+    withProgress(stats, progress, [&](auto &policy) {
+        if (!dagSearch(graph.numNodes(), source, -1, graph, graph.isTopologicallyOrdered(), labels, policy)) {
+            bellmanFordSearch(graph.numNodes(), source, graph, labels, policy);
+        }
+    });
+    return tree;
 }
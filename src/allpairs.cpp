@@ -0,0 +1,581 @@
+#include "../include/allpairs.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include "../include/mappedfile.h"
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MIN_PLUS_X86 1
+#include <immintrin.h>
+#endif
+using namespace std;
+
+static const char DISTANCE_FILE_MAGIC[8] = {'D', 'I', 'S', 'T', 'M', 'T', 'R', 'X'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Ints per cache line; rows are padded to a multiple of this
+static const size_t ROW_ALIGNMENT = 64 / sizeof(int);
+
+// Upper bound on the rows buffered between writes when the matrix goes to a file
+static const size_t OUTPUT_BLOCK_BYTES = size_t(64) << 20;
+
+// Floyd-Warshall tile edge; three 64 x 64 int tiles (48 KB) stay in L1/L2 while one is updated
+static const int FLOYD_WARSHALL_TILE = 64;
+
+// Floyd-Warshall works in [-FW_INF, FW_INF] so that the sum of any two entries fits in an
+// int without checks in the vector loop. A missing edge is FW_INF; sums through it may
+// drift below FW_INF by negative weights but stay above FW_UNREACHABLE
+static const int FW_INF = (1 << 30) - 1;
+static const int FW_UNREACHABLE = FW_INF / 2;
+
+static size_t paddedStride(const int num_nodes)
+{
+    return (static_cast<size_t>(num_nodes) + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+}
+
+// count ints starting on a cache line boundary
+static shared_ptr<int> allocateAligned(const size_t count)
+{
+    if (count == 0) {
+        return nullptr;
+    }
+    int *data = static_cast<int *>(::operator new(count * sizeof(int), align_val_t(64)));
+    return shared_ptr<int>(data, [](int *p) { ::operator delete(p, align_val_t(64)); });
+}
+
+DistanceMatrix::DistanceMatrix() = default;
+
+DistanceMatrix::DistanceMatrix(const int num_nodes)
+    : nodes(num_nodes)
+    , stride(paddedStride(num_nodes))
+{
+    shared_ptr<int> data = allocateAligned(static_cast<size_t>(nodes) * stride);
+    fill_n(data.get(), static_cast<size_t>(nodes) * stride, numeric_limits<int>::max());
+    values = data.get();
+    storage = std::move(data);
+}
+
+// Bellman-Ford from a virtual source with a zero-weight edge to every node, so every
+// potential starts at 0. Returns false and fills cycle if a negative cycle exists
+static bool computePotentials(const CSRGraph &graph, vector<int> &potential, vector<int> &cycle)
+{
+    const int num_nodes = graph.numNodes();
+    potential.assign(num_nodes, 0);
+    if (graph.minWeight() >= 0) {
+        return true; // all zero already satisfies w + h(u) - h(v) >= 0
+    }
+
+    // Every edge points forward, so one sweep in node order settles every potential
+    if (graph.isTopologicallyOrdered()) {
+        for (int fromNode = 0; fromNode < num_nodes; fromNode++) {
+            graph.forEachEdge(fromNode, [&](int toNode, int weight) {
+                potential[toNode] = min(potential[toNode], potential[fromNode] + weight);
+            });
+        }
+        return true;
+    }
+
+    // Rounds over the nodes whose potential changed in the previous round. With the
+    // virtual source a shortest path has at most num_nodes edges, so a change in
+    // round num_nodes means a negative cycle
+    vector<int> predecessor(num_nodes, -1);
+    vector<int> frontier(num_nodes), next;
+    vector<char> queued(num_nodes, 0);
+    for (int v = 0; v < num_nodes; v++) {
+        frontier[v] = v;
+    }
+    for (int round = 1; round <= num_nodes && !frontier.empty(); round++) {
+        next.clear();
+        for (int fromNode : frontier) {
+            queued[fromNode] = 0;
+        }
+        for (int fromNode : frontier) {
+            graph.forEachEdge(fromNode, [&](int toNode, int weight) {
+                if (potential[fromNode] + weight < potential[toNode]) {
+                    potential[toNode] = potential[fromNode] + weight;
+                    predecessor[toNode] = fromNode;
+                    if (!queued[toNode]) {
+                        queued[toNode] = 1;
+                        next.push_back(toNode);
+                    }
+                }
+            });
+        }
+        frontier.swap(next);
+    }
+    if (frontier.empty()) {
+        return true;
+    }
+
+    // Walking num_nodes predecessors back from a node still changing ends on the cycle
+    int at = frontier[0];
+    for (int i = 0; i < num_nodes && predecessor[at] != -1; i++) {
+        at = predecessor[at];
+    }
+    if (predecessor[at] == -1) {
+        return false; // not expected; report the cycle without its nodes
+    }
+    vector<char> onCycle(num_nodes, 0);
+    for (int v = at; !onCycle[v]; v = predecessor[v]) {
+        onCycle[v] = 1;
+        cycle.push_back(v);
+    }
+    reverse(cycle.begin(), cycle.end());
+    return false;
+}
+
+// The graph with w(u, v) + h(u) - h(v) as weights; the offsets and targets are shared with graph
+static CSRGraph reweight(const CSRGraph &graph, const vector<int> &potential)
+{
+    struct Reweighted {
+        CSRGraph original; // keeps the shared arrays alive
+        vector<int> weights;
+    };
+    auto owner = make_shared<Reweighted>();
+    owner->original = graph;
+    owner->weights.resize(graph.numEdges());
+
+    int minWeight = numeric_limits<int>::max();
+    int maxWeight = numeric_limits<int>::min();
+    for (int fromNode = 0; fromNode < graph.numNodes(); fromNode++) {
+        for (int i = graph.edgesBegin(fromNode); i < graph.edgesEnd(fromNode); i++) {
+            const long long weight = static_cast<long long>(graph.weight(i)) + potential[fromNode] - potential[graph.target(i)];
+            if (weight > numeric_limits<int>::max()) {
+                throw overflow_error("a reweighted edge does not fit in an int");
+            }
+            owner->weights[i] = static_cast<int>(weight);
+            minWeight = min(minWeight, owner->weights[i]);
+            maxWeight = max(maxWeight, owner->weights[i]);
+        }
+    }
+    if (graph.numEdges() == 0) {
+        minWeight = maxWeight = 0;
+    }
+    return CSRGraph::view(owner, graph.numNodes(), graph.numEdges(), graph.offsetsData(), graph.targetsData(),
+                          owner->weights.data(), minWeight, maxWeight, graph.isTopologicallyOrdered());
+}
+
+// Dijkstra from source on the reweighted graph, using row itself as the distance array,
+// then undoes the reweighting: d(s, v) = d'(s, v) - h(s) + h(v)
+static void fillRow(const CSRGraph &graph,
+                    const int source,
+                    const vector<int> &potential,
+                    int *row,
+                    vector<pair<int, int>> &heap)
+{
+    const int INF = numeric_limits<int>::max();
+    const int num_nodes = graph.numNodes();
+    fill_n(row, num_nodes, INF);
+
+    heap.clear();
+    row[source] = 0;
+    heap.emplace_back(0, source);
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater<>());
+        const pair<int, int> top_node = heap.back();
+        heap.pop_back();
+        const int from_node = top_node.second;
+        if (top_node.first > row[from_node]) {
+            continue; // stale entry
+        }
+        graph.forEachEdge(from_node, [&](int to_node, int weight) {
+            const int newDist = top_node.first + weight;
+            if (newDist < row[to_node]) {
+                row[to_node] = newDist;
+                heap.emplace_back(newDist, to_node);
+                push_heap(heap.begin(), heap.end(), greater<>());
+            }
+        });
+    }
+
+    for (int v = 0; v < num_nodes; v++) {
+        if (row[v] != INF) {
+            row[v] = static_cast<int>(static_cast<long long>(row[v]) - potential[source] + potential[v]);
+        }
+    }
+}
+
+AllPairsResult JohnsonAllPairs(const CSRGraph &graph, ThreadPool &pool, const string &outputPath)
+{
+    AllPairsResult result;
+    const int num_nodes = graph.numNodes();
+
+    vector<int> potential;
+    if (!computePotentials(graph, potential, result.cycle)) {
+        result.negativeCycle = true;
+        return result;
+    }
+    const CSRGraph searchGraph = graph.minWeight() < 0 ? reweight(graph, potential) : graph;
+
+    // One Dijkstra per row; each is long enough that sources are handed out one at a time
+    vector<vector<pair<int, int>>> heaps(pool.size());
+    auto fillRows = [&](int *rows, const size_t stride, const int firstSource, const int count) {
+        pool.parallelFor(count, 1, [&](int begin, int end, int worker) {
+            for (int i = begin; i < end; i++) {
+                fillRow(searchGraph, firstSource + i, potential, rows + i * stride, heaps[worker]);
+            }
+        });
+    };
+
+    if (outputPath.empty()) {
+        result.distances = DistanceMatrix(num_nodes);
+        if (num_nodes > 0) {
+            fillRows(result.distances.mutableRow(0), result.distances.rowStride(), 0, num_nodes);
+        }
+        return result;
+    }
+
+    ofstream out(outputPath, ios::binary | ios::trunc);
+    if (!out) {
+        throw runtime_error("cannot create distance file " + outputPath);
+    }
+    const size_t stride = paddedStride(num_nodes);
+    DistanceFileHeader header = {};
+    memcpy(header.magic, DISTANCE_FILE_MAGIC, sizeof(header.magic));
+    header.version = DISTANCE_FILE_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.numNodes = num_nodes;
+    header.rowStride = static_cast<int32_t>(stride);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // Blocks of rows, at least one per thread, written out as soon as they are done
+    const size_t rowBytes = max<size_t>(stride * sizeof(int), 1);
+    const int blockRows = min<long long>(num_nodes, max<long long>(pool.size(), OUTPUT_BLOCK_BYTES / rowBytes));
+    shared_ptr<int> block = allocateAligned(static_cast<size_t>(blockRows) * stride);
+    for (int first = 0; first < num_nodes; first += blockRows) {
+        const int count = min(blockRows, num_nodes - first);
+        fill_n(block.get(), static_cast<size_t>(count) * stride, 0); // the padding, so the file is deterministic
+        fillRows(block.get(), stride, first, count);
+        out.write(reinterpret_cast<const char *>(block.get()), static_cast<streamsize>(count * stride * sizeof(int)));
+    }
+
+    out.flush();
+    if (!out) {
+        throw runtime_error("cannot write distance file " + outputPath);
+    }
+    out.close();
+    result.distances = loadDistanceMatrix(outputPath);
+    return result;
+}
+
+AllPairsResult JohnsonAllPairs(const CSRGraph &graph, const int num_threads, const string &outputPath)
+{
+    ThreadPool pool(num_threads);
+    return JohnsonAllPairs(graph, pool, outputPath);
+}
+
+// The rectangle of a tile update: rows [i0, i1) and columns [j0, j1) are relaxed through
+// the intermediate nodes [k0, k1)
+struct TileRange {
+    int i0, i1, j0, j1, k0, k1;
+};
+
+using MinPlusFunction = void (*)(int *dist, int *next, size_t stride, const TileRange &tile);
+
+// dist[i][j] = max(min(dist[i][j], dist[i][k] + dist[k][j]), -FW_INF), taking next[i][k] as the
+// next hop when it improves; rows whose dist[i][k] is unreachable cannot improve anything
+static inline void minPlusRowScalar(int *di, int *ni, const int *dk, const int dik, const int nik, int j, const int j1)
+{
+    for (; j < j1; j++) {
+        const int via = max(dik + dk[j], -FW_INF);
+        if (via < di[j]) {
+            di[j] = via;
+            ni[j] = nik;
+        }
+    }
+}
+
+static void minPlusScalar(int *dist, int *next, const size_t stride, const TileRange &tile)
+{
+    for (int k = tile.k0; k < tile.k1; k++) {
+        const int *dk = dist + k * stride;
+        for (int i = tile.i0; i < tile.i1; i++) {
+            int *di = dist + i * stride;
+            const int dik = di[k];
+            if (dik > FW_UNREACHABLE) {
+                continue;
+            }
+            minPlusRowScalar(di, next + i * stride, dk, dik, next[i * stride + k], tile.j0, tile.j1);
+        }
+    }
+}
+
+#ifdef MIN_PLUS_X86
+__attribute__((target("sse4.1"))) static void minPlusSSE41(int *dist, int *next, const size_t stride, const TileRange &tile)
+{
+    const __m128i lowest = _mm_set1_epi32(-FW_INF);
+    for (int k = tile.k0; k < tile.k1; k++) {
+        const int *dk = dist + k * stride;
+        for (int i = tile.i0; i < tile.i1; i++) {
+            int *di = dist + i * stride;
+            int *ni = next + i * stride;
+            const int dik = di[k];
+            if (dik > FW_UNREACHABLE) {
+                continue;
+            }
+            const int nik = ni[k];
+            const __m128i vdik = _mm_set1_epi32(dik);
+            const __m128i vnik = _mm_set1_epi32(nik);
+            int j = tile.j0;
+            for (; j + 4 <= tile.j1; j += 4) {
+                const __m128i dij = _mm_loadu_si128(reinterpret_cast<const __m128i *>(di + j));
+                const __m128i dkj = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dk + j));
+                const __m128i via = _mm_max_epi32(_mm_add_epi32(vdik, dkj), lowest);
+                const __m128i better = _mm_cmpgt_epi32(dij, via);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(di + j), _mm_blendv_epi8(dij, via, better));
+                const __m128i nij = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ni + j));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(ni + j), _mm_blendv_epi8(nij, vnik, better));
+            }
+            minPlusRowScalar(di, ni, dk, dik, nik, j, tile.j1);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) static void minPlusAVX2(int *dist, int *next, const size_t stride, const TileRange &tile)
+{
+    const __m256i lowest = _mm256_set1_epi32(-FW_INF);
+    for (int k = tile.k0; k < tile.k1; k++) {
+        const int *dk = dist + k * stride;
+        for (int i = tile.i0; i < tile.i1; i++) {
+            int *di = dist + i * stride;
+            int *ni = next + i * stride;
+            const int dik = di[k];
+            if (dik > FW_UNREACHABLE) {
+                continue;
+            }
+            const int nik = ni[k];
+            const __m256i vdik = _mm256_set1_epi32(dik);
+            const __m256i vnik = _mm256_set1_epi32(nik);
+            int j = tile.j0;
+            for (; j + 8 <= tile.j1; j += 8) {
+                const __m256i dij = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(di + j));
+                const __m256i dkj = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dk + j));
+                const __m256i via = _mm256_max_epi32(_mm256_add_epi32(vdik, dkj), lowest);
+                const __m256i better = _mm256_cmpgt_epi32(dij, via);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(di + j), _mm256_blendv_epi8(dij, via, better));
+                const __m256i nij = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ni + j));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(ni + j), _mm256_blendv_epi8(nij, vnik, better));
+            }
+            minPlusRowScalar(di, ni, dk, dik, nik, j, tile.j1);
+        }
+    }
+}
+#endif
+
+bool isMinPlusKernelSupported(const MinPlusKernel kernel)
+{
+    switch (kernel) {
+    case MinPlusKernel::Auto:
+    case MinPlusKernel::Scalar:
+        return true;
+#ifdef MIN_PLUS_X86
+    case MinPlusKernel::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case MinPlusKernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+MinPlusKernel bestMinPlusKernel()
+{
+    for (MinPlusKernel kernel : {MinPlusKernel::AVX2, MinPlusKernel::SSE41}) {
+        if (isMinPlusKernelSupported(kernel)) {
+            return kernel;
+        }
+    }
+    return MinPlusKernel::Scalar;
+}
+
+const char *minPlusKernelName(const MinPlusKernel kernel)
+{
+    switch (kernel) {
+    case MinPlusKernel::Auto:
+        return "auto";
+    case MinPlusKernel::Scalar:
+        return "scalar";
+    case MinPlusKernel::SSE41:
+        return "sse4.1";
+    case MinPlusKernel::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+static MinPlusFunction minPlusFunction(const MinPlusKernel kernel)
+{
+    switch (kernel) {
+#ifdef MIN_PLUS_X86
+    case MinPlusKernel::SSE41:
+        return minPlusSSE41;
+    case MinPlusKernel::AVX2:
+        return minPlusAVX2;
+#endif
+    default:
+        return minPlusScalar;
+    }
+}
+
+AllPairsResult FloydWarshall(const CSRGraph &graph, ThreadPool &pool, MinPlusKernel kernel)
+{
+    if (kernel == MinPlusKernel::Auto) {
+        kernel = bestMinPlusKernel();
+    }
+    if (!isMinPlusKernelSupported(kernel)) {
+        throw invalid_argument(string("this processor does not support the ") + minPlusKernelName(kernel) + " kernel");
+    }
+    const MinPlusFunction minPlus = minPlusFunction(kernel);
+
+    const int num_nodes = graph.numNodes();
+    const long long longestEdge = max(abs(static_cast<long long>(graph.minWeight())), abs(static_cast<long long>(graph.maxWeight())));
+    if (static_cast<long long>(max(num_nodes - 1, 0)) * longestEdge >= FW_UNREACHABLE) {
+        throw overflow_error("path lengths of this graph may not fit in the Floyd-Warshall value range");
+    }
+
+    // The adjacency matrix; padding columns stay unreachable and are never updated
+    AllPairsResult result;
+    DistanceMatrix dist(num_nodes);
+    DistanceMatrix next(num_nodes);
+    const size_t stride = dist.rowStride();
+    int *d = num_nodes > 0 ? dist.mutableRow(0) : nullptr;
+    int *nx = num_nodes > 0 ? next.mutableRow(0) : nullptr;
+    pool.parallelFor(num_nodes, FLOYD_WARSHALL_TILE, [&](int begin, int end, int) {
+        for (int i = begin; i < end; i++) {
+            int *di = d + i * stride;
+            int *ni = nx + i * stride;
+            fill_n(di, stride, FW_INF);
+            fill_n(ni, stride, -1);
+            di[i] = 0;
+            ni[i] = i;
+            graph.forEachEdge(i, [&](int to, int weight) {
+                if (weight < di[to]) {
+                    di[to] = weight;
+                    ni[to] = to;
+                }
+            });
+        }
+    });
+
+    // Phases per diagonal tile: the tile itself, then its row and column, then the rest
+    const int tiles = (num_nodes + FLOYD_WARSHALL_TILE - 1) / FLOYD_WARSHALL_TILE;
+    auto span = [&](int tile) {
+        return make_pair(tile * FLOYD_WARSHALL_TILE, min(num_nodes, (tile + 1) * FLOYD_WARSHALL_TILE));
+    };
+    for (int kt = 0; kt < tiles; kt++) {
+        const pair<int, int> k = span(kt);
+        minPlus(d, nx, stride, {k.first, k.second, k.first, k.second, k.first, k.second});
+
+        // Tiles [0, tiles - 1) of the row, then those of the column, skipping the diagonal
+        pool.parallelFor(2 * (tiles - 1), 1, [&](int begin, int end, int) {
+            for (int t = begin; t < end; t++) {
+                const int other = t % (tiles - 1) < kt ? t % (tiles - 1) : t % (tiles - 1) + 1;
+                const pair<int, int> o = span(other);
+                if (t < tiles - 1) {
+                    minPlus(d, nx, stride, {k.first, k.second, o.first, o.second, k.first, k.second});
+                } else {
+                    minPlus(d, nx, stride, {o.first, o.second, k.first, k.second, k.first, k.second});
+                }
+            }
+        });
+
+        pool.parallelFor((tiles - 1) * (tiles - 1), 1, [&](int begin, int end, int) {
+            for (int t = begin; t < end; t++) {
+                const int it = t / (tiles - 1) < kt ? t / (tiles - 1) : t / (tiles - 1) + 1;
+                const int jt = t % (tiles - 1) < kt ? t % (tiles - 1) : t % (tiles - 1) + 1;
+                const pair<int, int> i = span(it), j = span(jt);
+                minPlus(d, nx, stride, {i.first, i.second, j.first, j.second, k.first, k.second});
+            }
+        });
+    }
+
+    // A node on a negative cycle reaches itself with a negative length
+    for (int v = 0; v < num_nodes; v++) {
+        if (d[v * stride + v] < 0) {
+            result.negativeCycle = true;
+            vector<char> seen(num_nodes, 0);
+            for (int at = v; at != -1 && !seen[at]; at = nx[at * stride + v]) {
+                seen[at] = 1;
+                result.cycle.push_back(at);
+            }
+            return result;
+        }
+    }
+
+    pool.parallelFor(num_nodes, FLOYD_WARSHALL_TILE, [&](int begin, int end, int) {
+        for (int i = begin; i < end; i++) {
+            int *di = d + i * stride;
+            int *ni = nx + i * stride;
+            for (size_t j = 0; j < stride; j++) {
+                if (di[j] > FW_UNREACHABLE) {
+                    di[j] = numeric_limits<int>::max();
+                    ni[j] = -1;
+                }
+            }
+        }
+    });
+    result.distances = dist;
+    result.nextHop = next;
+    return result;
+}
+
+AllPairsResult FloydWarshall(const vector<vector<Edge>> &adjacencyList, const int num_threads, const MinPlusKernel kernel)
+{
+    ThreadPool pool(num_threads);
+    return FloydWarshall(CSRGraph(adjacencyList), pool, kernel);
+}
+
+pair<vector<int>, int> extractPath(const AllPairsResult &result, const int from, const int to)
+{
+    if (result.nextHop.numNodes() == 0 && result.distances.numNodes() > 0) {
+        throw invalid_argument("the all-pairs result has no next hops");
+    }
+    const int distance = result.distances.at(from, to);
+    vector<int> path;
+    if (distance == numeric_limits<int>::max()) {
+        return {path, distance};
+    }
+    for (int at = from; at != to; at = result.nextHop.at(at, to)) {
+        path.push_back(at);
+    }
+    path.push_back(to);
+    return {path, distance};
+}
+
+DistanceMatrix loadDistanceMatrix(const string &path)
+{
+    auto file = make_shared<MappedFile>(path);
+
+    DistanceFileHeader header;
+    if (file->size() < sizeof(header)) {
+        throw runtime_error(path + " is not a distance file");
+    }
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, DISTANCE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        throw runtime_error(path + " is not a distance file");
+    }
+    if (header.version != DISTANCE_FILE_VERSION) {
+        throw runtime_error(path + " has unsupported distance file version " + to_string(header.version));
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw runtime_error(path + " was written on a machine with a different byte order");
+    }
+    if (header.numNodes < 0 || header.rowStride < header.numNodes || header.rowStride % ROW_ALIGNMENT != 0) {
+        throw runtime_error(path + " has a corrupt header");
+    }
+    if (file->size() < sizeof(header) + static_cast<size_t>(header.numNodes) * header.rowStride * sizeof(int)) {
+        throw runtime_error(path + " is truncated");
+    }
+
+    DistanceMatrix matrix;
+    matrix.nodes = header.numNodes;
+    matrix.stride = header.rowStride;
+    matrix.values = reinterpret_cast<const int *>(file->data() + sizeof(header));
+    matrix.storage = std::move(file);
+    return matrix;
+}
@@ -0,0 +1,178 @@
+#include "../include/alt.h"
+#include "../include/algorithm.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+using namespace std;
+
+// Choose the landmarks one by one and record their forward/backward distances
+ALTIndex::ALTIndex(const CSRGraph &graph,
+                   const CSRGraph &reverseGraph,
+                   int numLandmarks,
+                   LandmarkSelection selection,
+                   unsigned seed)
+{
+    const int INF = numeric_limits<int>::max();
+    const int num_nodes = graph.numNodes();
+    const int k = max(0, min(numLandmarks, num_nodes));
+    if (k == 0) {
+        return;
+    }
+
+    mt19937 gen(seed);
+    table.assign(static_cast<size_t>(num_nodes) * 2 * k, INF);
+
+    // Random selection: the first k nodes of a shuffled id list
+    vector<int> shuffled;
+    if (selection == LandmarkSelection::Random) {
+        shuffled.resize(num_nodes);
+        iota(shuffled.begin(), shuffled.end(), 0);
+        shuffle(shuffled.begin(), shuffled.end(), gen);
+    }
+
+    // Farthest-point selection: separation[v] is the smallest round-trip distance from v
+    // to any chosen landmark (unreachable counts as very far, so it gets covered first)
+    const long long UNREACHABLE = numeric_limits<long long>::max() / 4;
+    vector<long long> separation(num_nodes, numeric_limits<long long>::max());
+    int next = uniform_int_distribution<int>(0, num_nodes - 1)(gen);
+
+    for (int i = 0; i < k; i++) {
+        int landmark = selection == LandmarkSelection::Random ? shuffled[i] : next;
+        landmarkNodes.push_back(landmark);
+
+        // d(L, v) over the graph and d(v, L) over the reverse graph
+        ShortestPathTree fromLandmark = DijkstraTree(graph, landmark);
+        ShortestPathTree toLandmark = DijkstraTree(reverseGraph, landmark);
+
+        for (int v = 0; v < num_nodes; v++) {
+            size_t slot = (static_cast<size_t>(v) * k + i) * 2;
+            table[slot] = fromLandmark.distance[v];
+            table[slot + 1] = toLandmark.distance[v];
+        }
+
+        if (selection == LandmarkSelection::FarthestPoint) {
+            next = -1;
+            for (int v = 0; v < num_nodes; v++) {
+                long long forward = fromLandmark.distance[v] == INF ? UNREACHABLE : fromLandmark.distance[v];
+                long long backward = toLandmark.distance[v] == INF ? UNREACHABLE : toLandmark.distance[v];
+                separation[v] = min(separation[v], forward + backward);
+                if (separation[v] > 0 && (next == -1 || separation[v] > separation[next])) {
+                    next = v;
+                }
+            }
+            if (next == -1) {
+                break; // every node already is a landmark
+            }
+        }
+    }
+
+    // Farthest-point may stop early; shrink the rows to the landmarks actually chosen
+    const int chosen = landmarkNodes.size();
+    if (chosen < k) {
+        vector<int> compact(static_cast<size_t>(num_nodes) * 2 * chosen);
+        for (int v = 0; v < num_nodes; v++) {
+            copy_n(&table[static_cast<size_t>(v) * 2 * k], 2 * chosen, &compact[static_cast<size_t>(v) * 2 * chosen]);
+        }
+        table.swap(compact);
+    }
+}
+
+// Best triangle-inequality bound over all landmarks
+int ALTIndex::lowerBound(const int node, const int *targetDistances) const
+{
+    const int INF = numeric_limits<int>::max();
+    const int k = landmarkNodes.size();
+    const int *row = targetRow(node);
+    int bound = 0;
+
+    for (int i = 0; i < k; i++) {
+        int fromL_v = row[2 * i], toL_v = row[2 * i + 1];
+        int fromL_t = targetDistances[2 * i], toL_t = targetDistances[2 * i + 1];
+
+        // d(v, t) >= d(L, t) - d(L, v)
+        if (fromL_v != INF && fromL_t != INF) {
+            bound = max(bound, fromL_t - fromL_v);
+        }
+        // d(v, t) >= d(v, L) - d(t, L)
+        if (toL_v != INF && toL_t != INF) {
+            bound = max(bound, toL_v - toL_t);
+        }
+    }
+    return bound;
+}
+
+// A* with the landmark heuristic; the bound is consistent, so each node is settled once
+template<typename Stats>
+static pair<vector<int>, int> altSearch(const int num_nodes,
+                                        const int source,
+                                        const int target,
+                                        const CSRGraph &graph,
+                                        const ALTIndex &index,
+                                        Stats &stats)
+{
+    ShortestPathTree tree;
+    tree.distance.assign(num_nodes, numeric_limits<int>::max());
+    tree.predecessor.assign(num_nodes, -1);
+    vector<int> &distance = tree.distance;
+    vector<int> &predecessor = tree.predecessor;
+
+    vector<char> closed(num_nodes, 0); // settled nodes; with a consistent bound their distance is final
+    const int *targetDistances = index.targetRow(target);
+
+    // min-heap keyed by distance + lower bound
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+
+    distance[source] = 0;
+    pq.emplace(index.lowerBound(source, targetDistances), source);
+    stats.onRound();
+    stats.onPush(pq.size());
+
+    while (!pq.empty()) {
+        pair<int, int> top_node = pq.top();
+        int from_node = top_node.second;
+        pq.pop();
+        stats.onPop();
+
+        // stale entry: the node was already settled through a better queue entry
+        if (closed[from_node]) {
+            stats.onStale();
+            continue;
+        }
+        closed[from_node] = 1;
+        stats.onSettle();
+
+        // early termination if the target node is reached
+        if (from_node == target) {
+            break;
+        }
+
+        graph.forEachEdge(from_node, [&](int to_node, int weight) {
+            stats.onRelax();
+            if (distance[from_node] + weight < distance[to_node]) {
+                distance[to_node] = distance[from_node] + weight;
+                predecessor[to_node] = from_node;
+                pq.emplace(distance[to_node] + index.lowerBound(to_node, targetDistances), to_node);
+                stats.onImprove();
+                stats.onPush(pq.size());
+            }
+        });
+    }
+
+    return extractPath(tree, target);
+}
+
+pair<vector<int>, int> ALTDijkstra(const int num_nodes,
+                                   const int source,
+                                   const int target,
+                                   const CSRGraph &graph,
+                                   const ALTIndex &index,
+                                   SearchStats *stats)
+{
+    if (stats) {
+        return altSearch(num_nodes, source, target, graph, index, *stats);
+    }
+    NoStats none;
+    return altSearch(num_nodes, source, target, graph, index, none);
+}
@@ -1,71 +1,744 @@
-#include <iostream>
-#include <vector>
+#include <algorithm>
 #include <chrono>
+#include <fstream>
+#include <functional>
 #include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "../include/algorithm.h"
+#include "../include/alt.h"
+#include "../include/benchmarkstudies.h"
+#include "../include/contractionhierarchy.h"
+#include "../include/graphimport.h"
+#include "../include/parallel.h"
+#include "../include/searchstats.h"
+#include "../include/treecache.h"
 using namespace std;
 
+// Distance reported for a query whose source reaches a negative cycle
+static const int NEGATIVE_CYCLE = numeric_limits<int>::min();
+
+// Nodes above which sequential Bellman-Ford only runs when --algorithms names it
+static const int BELLMAN_FORD_DEFAULT_MAX_NODES = 100000;
 
 /**
- * @brief Entry point for benchmarking graph algorithms.
+ * @brief The graphs an algorithm can be benchmarked on.
+ */
+enum class GraphRequirement {
+    Any,
+    NonNegative,      // no negative weights
+    NonNegativeOrDAG, // negative weights only without cycles, so there is no negative cycle
+    DAG               // node ids in topological order
+};
+
+/**
+ * @brief A benchmarked algorithm.
  *
- * This program compares the execution time of Dijkstra's and
- * Bellman-Ford algorithms on randomly generated graphs of various sizes.
- * The results are printed in a formatted table.
+ * Exactly one of prepare and batch is set. prepare builds whatever the
+ * algorithm precomputes (timed as preprocessing) and returns a function that
+ * answers one query with its distance; it fills in the SearchStats when given
+ * one, or leaves it untouched if the algorithm is not instrumented. batch
+ * answers a whole query list at once; each of its samples is the time of a
+ * pass divided by the number of queries.
+ */
+struct BenchmarkAlgorithm {
+    string name;
+    string description;
+    GraphRequirement requirement;
+    bool parallel; // run once per requested thread count
+    function<function<int(int, int, SearchStats *)>(const CSRGraph &, ThreadPool &, const BenchmarkOptions &)> prepare;
+    function<vector<int>(const CSRGraph &, const vector<pair<int, int>> &, ThreadPool &)> batch;
+    int defaultMaxNodes = 0; // if set, larger graphs are skipped unless --algorithms names the algorithm
+};
+
+/**
+ * @brief One row of the report: an algorithm on a graph at a thread count.
  */
-int main() {
-    // Different sizes of graphs to test performance
-    vector<int> nodeCounts = {100, 1000, 10000, 100000};
-
-    // Benchmark 1: Both Dijkstra and Bellman-Ford on general directed graphs
-    cout << "| Nodes     | Dijkstra Time (s)   | Bellman-Ford Time (s) |\n";
-    cout << "|-----------|---------------------|-----------------------|\n";
-    for (int num_nodes : nodeCounts) {
-        // Generate a random directed graph
-        vector<vector<Edge>> graph_DG = generateDirectedGraph(num_nodes, 20, 1, 10);
-        int source = 0;
-        int target = num_nodes - 1;
-
-        // Time Dijkstra algorithm
-        auto startD = chrono::high_resolution_clock::now();
-        Dijkstra(num_nodes, source, target, graph_DG);
-        auto endD = chrono::high_resolution_clock::now();
-        chrono::duration<double> durationD = endD - startD;
-
-        // Time Bellman-Ford algorithm
-        auto startB = chrono::high_resolution_clock::now();
-        BellmanFord(num_nodes, source, target, graph_DG);
-        auto endB = chrono::high_resolution_clock::now();
-        chrono::duration<double> durationB = endB - startB;
-
-        // Output formatted results for this graph size
-        cout << "| " << setw(10) << left << num_nodes
-             << "| " << fixed << setw(20) << setprecision(6) << durationD.count()
-             << "| " << fixed << setw(22) << setprecision(6) << durationB.count()
-             << "|\n";
+struct BenchmarkResult {
+    string graphType;
+    int nodes = 0;
+    long long edges = 0;
+    int degree = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    string algorithm;
+    int threads = 1;
+    string status = "ok";       // "ok", "mismatch" or "skipped: <reason>"
+    double generateSeconds = 0; // median time to generate or load the graph
+    double prepareSeconds = 0;
+    TimeSummary queryTime;
+    int mismatches = 0; // queries whose distance differs from the first algorithm run on the graph
+    bool counted = false; // whether counters holds the totals of an instrumented pass over the queries
+    SearchStats counters;
+};
+
+// The algorithms the harness knows, in the order they run
+static vector<BenchmarkAlgorithm> benchmarkAlgorithms()
+{
+    using Query = function<int(int, int, SearchStats *)>;
+    vector<BenchmarkAlgorithm> algorithms;
+
+    algorithms.push_back({"dijkstra", "Dijkstra with a binary heap", GraphRequirement::NonNegative, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            return Query([&graph](int source, int target, SearchStats *stats) {
+                return DijkstraHeap(graph.numNodes(), source, target, graph, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"bucket", "Dijkstra with a bucket queue", GraphRequirement::NonNegative, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            return Query([&graph](int source, int target, SearchStats *stats) {
+                return DijkstraBucket(graph.numNodes(), source, target, graph, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"workspace", "Dijkstra reusing one QueryWorkspace", GraphRequirement::NonNegative, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            auto workspace = make_shared<QueryWorkspace>(graph.numNodes());
+            return Query([&graph, workspace](int source, int target, SearchStats *stats) {
+                return Dijkstra(graph.numNodes(), source, target, graph, *workspace, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"bidirectional", "bidirectional Dijkstra; preprocessing reverses the graph", GraphRequirement::NonNegative, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            auto reverse = make_shared<CSRGraph>(graph.reversed());
+            return Query([&graph, reverse](int source, int target, SearchStats *stats) {
+                return BidirectionalDijkstra(graph.numNodes(), source, target, graph, *reverse, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"alt", "ALT (landmark A*); preprocessing builds the landmark tables", GraphRequirement::NonNegative, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &options) {
+            auto index = make_shared<ALTIndex>(graph, graph.reversed(), options.landmarks);
+            return Query([&graph, index](int source, int target, SearchStats *stats) {
+                return ALTDijkstra(graph.numNodes(), source, target, graph, *index, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"ch", "contraction hierarchy; preprocessing contracts the graph", GraphRequirement::NonNegative, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            auto hierarchy = make_shared<ContractionHierarchy>(graph);
+            return Query([hierarchy](int source, int target, SearchStats *stats) {
+                return hierarchy->query(source, target, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"delta", "parallel delta-stepping (a full tree per query, path read out of it)", GraphRequirement::NonNegative, true,
+        [](const CSRGraph &graph, ThreadPool &pool, const BenchmarkOptions &) {
+            return Query([&graph, &pool](int source, int target, SearchStats *) {
+                return extractPath(DeltaSteppingTree(graph, source, 0, pool), target).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"bellman-ford", "sequential Bellman-Ford (no negative-cycle detection)", GraphRequirement::NonNegativeOrDAG, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            return Query([&graph](int source, int target, SearchStats *stats) {
+                return BellmanFord(graph.numNodes(), source, target, graph, stats).second;
+            });
+        }, nullptr, BELLMAN_FORD_DEFAULT_MAX_NODES});
+    algorithms.push_back({"frontier-bf", "parallel frontier Bellman-Ford with negative-cycle detection", GraphRequirement::Any, true,
+        [](const CSRGraph &graph, ThreadPool &pool, const BenchmarkOptions &) {
+            return Query([&graph, &pool](int source, int target, SearchStats *) {
+                BellmanFordResult result = BellmanFordFrontier(graph.numNodes(), source, target, graph, pool);
+                return result.negativeCycle ? NEGATIVE_CYCLE : result.distance;
+            });
+        }, nullptr});
+    algorithms.push_back({"dag", "relaxation in topological order (DAGs only)", GraphRequirement::DAG, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            return Query([&graph](int source, int target, SearchStats *stats) {
+                return DAGShortestPath(graph.numNodes(), source, target, graph, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"tree-cache", "whole trees kept in a ShortestPathTreeCache; passes after the first hit", GraphRequirement::NonNegativeOrDAG, false,
+        [](const CSRGraph &graph, ThreadPool &, const BenchmarkOptions &) {
+            auto cache = make_shared<ShortestPathTreeCache>();
+            cache->setGraph(graph);
+            return Query([cache](int source, int target, SearchStats *stats) {
+                return cache->query(source, target, stats).second;
+            });
+        }, nullptr});
+    algorithms.push_back({"batch", "BatchShortestPaths with Dijkstra over all query pairs at once", GraphRequirement::NonNegative, true,
+        nullptr, [](const CSRGraph &graph, const vector<pair<int, int>> &queries, ThreadPool &pool) {
+            vector<int> distances;
+            for (const auto &result : BatchShortestPaths(graph, queries, BatchAlgorithm::Dijkstra, pool)) {
+                distances.push_back(result.second);
+            }
+            return distances;
+        }});
+    return algorithms;
+}
+
+// Runs one algorithm on a graph: preprocessing, warm-up, the timed passes over the queries,
+// then one untimed pass that collects the search counters
+static void runAlgorithm(const BenchmarkAlgorithm &algorithm,
+                         const CSRGraph &graph,
+                         const vector<pair<int, int>> &warmupQueries,
+                         const vector<pair<int, int>> &queries,
+                         ThreadPool &pool,
+                         const BenchmarkOptions &options,
+                         BenchmarkResult &result,
+                         vector<int> &distances)
+{
+    vector<double> samples;
+    distances.assign(queries.size(), 0);
+
+    if (algorithm.batch) {
+        algorithm.batch(graph, warmupQueries, pool);
+        for (int repetition = 0; repetition < options.repetitions; repetition++) {
+            auto start = chrono::steady_clock::now();
+            distances = algorithm.batch(graph, queries, pool);
+            const double seconds = secondsSince(start);
+            samples.insert(samples.end(), queries.size(), seconds / queries.size());
+        }
+    } else {
+        auto startP = chrono::steady_clock::now();
+        function<int(int, int, SearchStats *)> query = algorithm.prepare(graph, pool, options);
+        result.prepareSeconds = secondsSince(startP);
+
+        for (const auto &warmup : warmupQueries) {
+            query(warmup.first, warmup.second, nullptr);
+        }
+        for (int repetition = 0; repetition < options.repetitions; repetition++) {
+            for (size_t i = 0; i < queries.size(); i++) {
+                auto start = chrono::steady_clock::now();
+                distances[i] = query(queries[i].first, queries[i].second, nullptr);
+                samples.push_back(secondsSince(start));
+            }
+        }
+
+        // Kept out of the timed passes so the counters cannot skew the times
+        for (const auto &q : queries) {
+            SearchStats stats;
+            query(q.first, q.second, &stats);
+            result.counters += stats;
+        }
+        // every instrumented search counts at least one round
+        result.counted = !queries.empty() && result.counters.rounds > 0;
+    }
+    result.queryTime = summarize(samples);
+}
+
+static string formatMicroseconds(const double seconds)
+{
+    ostringstream out;
+    out << fixed << setprecision(1) << seconds * 1e6;
+    return out.str();
+}
+
+static void printTableHeader()
+{
+    cout << "| Algorithm      | Threads | Prep (s)    | Median (us)  | p90 (us)     | p99 (us)     | Mean (us)    | Queries/s    | Check        |\n";
+    cout << "|----------------|---------|-------------|--------------|--------------|--------------|--------------|--------------|--------------|\n";
+}
+
+static void printTableRow(const BenchmarkResult &result)
+{
+    cout << "| " << setw(15) << left << result.algorithm
+         << "| " << setw(8) << result.threads;
+    if (result.status.compare(0, 7, "skipped") == 0) {
+        cout << "| " << setw(103) << result.status << "|\n";
+        return;
+    }
+    cout << "| " << fixed << setw(12) << setprecision(6) << result.prepareSeconds
+         << "| " << setw(13) << formatMicroseconds(result.queryTime.median)
+         << "| " << setw(13) << formatMicroseconds(result.queryTime.p90)
+         << "| " << setw(13) << formatMicroseconds(result.queryTime.p99)
+         << "| " << setw(13) << formatMicroseconds(result.queryTime.mean)
+         << "| " << fixed << setw(13) << setprecision(1) << result.queryTime.throughput
+         << "| " << setw(13) << (result.mismatches ? to_string(result.mismatches) + " differ" : string("ok"))
+         << "|\n";
+}
+
+// Per-query mean of a counter total
+static double perQuery(const long long total, const int queries)
+{
+    return queries > 0 ? static_cast<double>(total) / queries : 0;
+}
+
+// Per-query means of the search counters of the instrumented algorithms; the peak queue size is the largest of any query
+static void printCountersTable(const vector<BenchmarkResult> &results, const size_t first, const int queries)
+{
+    bool any = false;
+    for (size_t i = first; i < results.size(); i++) {
+        any = any || results[i].counted;
+    }
+    if (!any) {
+        return;
+    }
+    cout << "\nSearch counters per query:\n\n";
+    cout << "| Algorithm      | Settled      | Relaxed      | Improved     | Pushes       | Pops         | Stale        | Rounds       | Peak queue   |\n";
+    cout << "|----------------|--------------|--------------|--------------|--------------|--------------|--------------|--------------|--------------|\n";
+    for (size_t i = first; i < results.size(); i++) {
+        const BenchmarkResult &result = results[i];
+        if (!result.counted) {
+            continue;
+        }
+        const SearchStats &c = result.counters;
+        cout << "| " << setw(15) << left << result.algorithm << fixed << setprecision(1);
+        for (long long total : {c.nodesSettled, c.edgesRelaxed, c.successfulRelaxations, c.queuePushes,
+                                c.queuePops, c.staleEntries, c.rounds}) {
+            cout << "| " << setw(13) << perQuery(total, queries);
+        }
+        cout << "| " << setw(13) << c.peakQueueSize << "|\n";
     }
+}
+
+// Benchmarks every selected algorithm on one graph and appends a result per algorithm and thread count
+static void benchmarkGraph(const CSRGraph &graph,
+                           BenchmarkResult base,
+                           const vector<BenchmarkAlgorithm> &algorithms,
+                           const vector<unique_ptr<ThreadPool>> &pools,
+                           const BenchmarkOptions &options,
+                           vector<BenchmarkResult> &results)
+{
+    const int num_nodes = graph.numNodes();
+    base.nodes = num_nodes;
+    base.edges = graph.numEdges();
+    base.minWeight = graph.minWeight();
+    base.maxWeight = graph.maxWeight();
+
+    cout << base.graphType << " graph: " << num_nodes << " nodes, " << base.edges << " edges, weights "
+         << base.minWeight << ".." << base.maxWeight << ", built in " << fixed << setprecision(6)
+         << base.generateSeconds << " s (median)\n\n";
+    if (num_nodes == 0) {
+        return;
+    }
+    printTableHeader();
 
+    // The same seeded query pairs for every algorithm on this graph
+    mt19937_64 random(options.seed);
+    uniform_int_distribution<int> node(0, num_nodes - 1);
+    vector<pair<int, int>> warmupQueries(options.warmup);
+    vector<pair<int, int>> queries(options.queries);
+    for (auto &query : warmupQueries) {
+        query = {node(random), node(random)};
+    }
+    for (auto &query : queries) {
+        query = {node(random), node(random)};
+    }
+
+    vector<int> reference; // distances of the first algorithm that ran
+    const size_t firstResult = results.size();
+    for (const BenchmarkAlgorithm &algorithm : algorithms) {
+        const size_t poolCount = algorithm.parallel ? pools.size() : 1;
+        for (size_t p = 0; p < poolCount; p++) {
+            ThreadPool &pool = *pools[p];
+            BenchmarkResult result = base;
+            result.algorithm = algorithm.name;
+            result.threads = algorithm.parallel ? pool.size() : 1;
+
+            const bool negative = graph.minWeight() < 0;
+            const bool dag = graph.isTopologicallyOrdered();
+            if (algorithm.requirement == GraphRequirement::NonNegative && negative) {
+                result.status = "skipped: negative weights";
+            } else if (algorithm.requirement == GraphRequirement::NonNegativeOrDAG && negative && !dag) {
+                result.status = "skipped: negative weights on a graph that may have cycles";
+            } else if (algorithm.requirement == GraphRequirement::DAG && !dag) {
+                result.status = "skipped: not a DAG";
+            } else if (options.defaultAlgorithms && algorithm.defaultMaxNodes > 0 && graph.numNodes() > algorithm.defaultMaxNodes) {
+                result.status = "skipped: over " + to_string(algorithm.defaultMaxNodes) + " nodes unless named in --algorithms";
+            } else {
+                vector<int> distances;
+                runAlgorithm(algorithm, graph, warmupQueries, queries, pool, options, result, distances);
+                if (reference.empty()) {
+                    reference = distances;
+                }
+                for (size_t i = 0; i < queries.size(); i++) {
+                    result.mismatches += distances[i] != reference[i];
+                }
+                if (result.mismatches) {
+                    result.status = "mismatch";
+                }
+            }
+
+            printTableRow(result);
+            results.push_back(result);
+        }
+    }
+    printCountersTable(results, firstResult, options.queries);
     cout << "\n\n";
+}
+
+static void writeJson(const string &path, const BenchmarkOptions &options, const vector<BenchmarkResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"queries\": " << options.queries
+        << ", \"repetitions\": " << options.repetitions << ", \"warmup\": " << options.warmup
+        << ", \"landmarks\": " << options.landmarks << ", \"file\": " << jsonString(options.file) << "},\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graphType) << ", \"nodes\": " << r.nodes
+            << ", \"edges\": " << r.edges << ", \"degree\": " << r.degree << ", \"min_weight\": " << r.minWeight
+            << ", \"max_weight\": " << r.maxWeight << ", \"algorithm\": " << jsonString(r.algorithm)
+            << ", \"threads\": " << r.threads << ", \"status\": " << jsonString(r.status)
+            << ", \"generate_s\": " << r.generateSeconds << ", \"prepare_s\": " << r.prepareSeconds
+            << ", \"samples\": " << r.queryTime.samples << ", \"median_s\": " << r.queryTime.median
+            << ", \"p90_s\": " << r.queryTime.p90 << ", \"p99_s\": " << r.queryTime.p99
+            << ", \"mean_s\": " << r.queryTime.mean << ", \"queries_per_s\": " << r.queryTime.throughput
+            << ", \"mismatches\": " << r.mismatches;
+        if (r.counted) {
+            const SearchStats &c = r.counters;
+            out << ", \"counters_per_query\": {\"settled\": " << perQuery(c.nodesSettled, options.queries)
+                << ", \"relaxed\": " << perQuery(c.edgesRelaxed, options.queries)
+                << ", \"improved\": " << perQuery(c.successfulRelaxations, options.queries)
+                << ", \"pushes\": " << perQuery(c.queuePushes, options.queries)
+                << ", \"pops\": " << perQuery(c.queuePops, options.queries)
+                << ", \"stale\": " << perQuery(c.staleEntries, options.queries)
+                << ", \"rounds\": " << perQuery(c.rounds, options.queries)
+                << ", \"peak_queue\": " << c.peakQueueSize << "}";
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeCsv(const string &path, const BenchmarkOptions &options, const vector<BenchmarkResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "graph,nodes,edges,degree,min_weight,max_weight,algorithm,threads,status,generate_s,prepare_s,"
+           "samples,median_s,p90_s,p99_s,mean_s,queries_per_s,mismatches,settled,relaxed,improved,pushes,pops,"
+           "stale,rounds,peak_queue\n";
+    for (const BenchmarkResult &r : results) {
+        out << r.graphType << ',' << r.nodes << ',' << r.edges << ',' << r.degree << ',' << r.minWeight << ','
+            << r.maxWeight << ',' << r.algorithm << ',' << r.threads << ",\"" << r.status << "\","
+            << r.generateSeconds << ',' << r.prepareSeconds << ',' << r.queryTime.samples << ','
+            << r.queryTime.median << ',' << r.queryTime.p90 << ',' << r.queryTime.p99 << ',' << r.queryTime.mean
+            << ',' << r.queryTime.throughput << ',' << r.mismatches;
+        // counters are per-query means, empty for algorithms without them
+        const SearchStats &c = r.counters;
+        for (long long total : {c.nodesSettled, c.edgesRelaxed, c.successfulRelaxations, c.queuePushes,
+                                c.queuePops, c.staleEntries, c.rounds}) {
+            out << ',';
+            if (r.counted) {
+                out << perQuery(total, options.queries);
+            }
+        }
+        out << ',';
+        if (r.counted) {
+            out << c.peakQueueSize;
+        }
+        out << '\n';
+    }
+}
+
+static void printUsage(const vector<BenchmarkAlgorithm> &algorithms, const vector<BenchmarkStudy> &studies)
+{
+    cout << "Usage: Benchmark [options] [graph file]\n\n"
+            "Generates graphs (or loads one), answers random query pairs with the selected\n"
+            "algorithms and reports median, p90, p99 and mean query time and throughput,\n"
+            "then the per-query search counters (nodes settled, edges relaxed, queue\n"
+            "operations) of the instrumented algorithms from one extra untimed pass.\n\n"
+            "  --algorithms a,b,...   algorithms to run (default: all but tree-cache and batch; bellman-ford\n"
+            "                         only up to 100000 nodes unless named here)\n"
+            "  --graphs t,...         generated graph types: directed, dag (default: both)\n"
+            "  --sizes n,...          node counts (default: 1000,10000,100000)\n"
+            "  --degrees d,...        average out-degrees (default: 20)\n"
+            "  --weights lo:hi,...    weight ranges (default: 1:10 for directed graphs, -10:10 for DAGs)\n"
+            "  --threads t,...        thread counts of the parallel algorithms, 0 = all cores (default: 0)\n"
+            "  --file path            benchmark a DIMACS .gr, edge-list or binary graph file instead\n"
+            "  --seed s               seed of the graphs and query pairs (default: 42)\n"
+            "  --queries q            query pairs per graph (default: 100)\n"
+            "  --repetitions r        timed passes over the queries, and generator runs (default: 3)\n"
+            "  --warmup w             untimed queries per algorithm before timing (default: 5)\n"
+            "  --landmarks k          ALT landmarks (default: 16)\n"
+            "  --densities f,...      --crossover degrees as fractions of n - 1\n"
+            "                         (default: 0.01,0.05,0.1,0.25,0.5,1)\n"
+            "  --json path            also write the results as JSON\n"
+            "  --csv path             also write the results as CSV\n"
+            "  --help                 show this text\n\n"
+            "Studies, run instead of the query benchmark; at most one per run:\n";
+    for (const BenchmarkStudy &study : studies) {
+        string usage = study.usage;
+        for (size_t line = usage.find('\n'); line != string::npos; line = usage.find('\n', line + 1)) {
+            usage.insert(line + 1, 25, ' ');
+        }
+        cout << "  " << setw(21) << left << study.flag + " n,..." << "  " << usage << "\n";
+    }
+    cout << "\nAlgorithms:\n";
+    for (const BenchmarkAlgorithm &algorithm : algorithms) {
+        cout << "  " << setw(15) << left << algorithm.name << algorithm.description << "\n";
+    }
+}
+
+static vector<string> splitList(const string &text)
+{
+    vector<string> items;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static long long parseNumber(const string &text, const string &flag)
+{
+    size_t used = 0;
+    long long value = 0;
+    try {
+        value = stoll(text, &used);
+    } catch (const exception &) {
+        used = 0;
+    }
+    if (text.empty() || used != text.size()) {
+        throw invalid_argument("invalid number \"" + text + "\" for " + flag);
+    }
+    return value;
+}
+
+static vector<int> parseNumbers(const string &text, const string &flag)
+{
+    vector<int> values;
+    for (const string &item : splitList(text)) {
+        values.push_back(parseNumber(item, flag));
+    }
+    return values;
+}
+
+// Fills options from the command line; returns false if --help was given
+static bool parseOptions(int argc,
+                         char *argv[],
+                         const vector<BenchmarkAlgorithm> &algorithms,
+                         const vector<BenchmarkStudy> &studies,
+                         BenchmarkOptions &options)
+{
+    auto isStudy = [&](const string &flag) {
+        return any_of(studies.begin(), studies.end(), [&](const BenchmarkStudy &study) { return study.flag == flag; });
+    };
+
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--help" || flag == "-h") {
+            return false;
+        }
+        if (flag.compare(0, 2, "--") != 0) {
+            options.file = flag;
+            continue;
+        }
+
+        // Both "--flag value" and "--flag=value"
+        string value;
+        const size_t equals = flag.find('=');
+        if (equals != string::npos) {
+            value = flag.substr(equals + 1);
+            flag = flag.substr(0, equals);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        } else {
+            throw invalid_argument(flag + " needs a value");
+        }
+
+        if (flag == "--algorithms") {
+            options.algorithms = splitList(value);
+            options.defaultAlgorithms = false;
+            for (const string &name : options.algorithms) {
+                if (none_of(algorithms.begin(), algorithms.end(), [&](const BenchmarkAlgorithm &a) { return a.name == name; })) {
+                    throw invalid_argument("unknown algorithm \"" + name + "\"");
+                }
+            }
+        } else if (flag == "--graphs") {
+            options.graphTypes = splitList(value);
+            for (const string &type : options.graphTypes) {
+                if (type != "directed" && type != "dag") {
+                    throw invalid_argument("unknown graph type \"" + type + "\"");
+                }
+            }
+        } else if (flag == "--sizes") {
+            options.sizes = parseNumbers(value, flag);
+        } else if (flag == "--degrees") {
+            options.degrees = parseNumbers(value, flag);
+        } else if (flag == "--weights") {
+            options.weightRanges.clear();
+            for (const string &range : splitList(value)) {
+                const size_t colon = range.find(':', 1);
+                if (colon == string::npos) {
+                    throw invalid_argument("weight range \"" + range + "\" is not lo:hi");
+                }
+                const int low = parseNumber(range.substr(0, colon), flag);
+                const int high = parseNumber(range.substr(colon + 1), flag);
+                if (low > high) {
+                    throw invalid_argument("weight range \"" + range + "\" is empty");
+                }
+                options.weightRanges.push_back({low, high});
+            }
+            if (options.weightRanges.empty()) {
+                throw invalid_argument("lists given on the command line must not be empty");
+            }
+        } else if (flag == "--threads") {
+            options.threads = parseNumbers(value, flag);
+        } else if (flag == "--file") {
+            options.file = value;
+        } else if (flag == "--seed") {
+            options.seed = parseNumber(value, flag);
+        } else if (flag == "--queries") {
+            options.queries = parseNumber(value, flag);
+        } else if (flag == "--repetitions") {
+            options.repetitions = parseNumber(value, flag);
+        } else if (flag == "--warmup") {
+            options.warmup = parseNumber(value, flag);
+        } else if (flag == "--landmarks") {
+            options.landmarks = parseNumber(value, flag);
+        } else if (isStudy(flag)) {
+            if (!options.study.empty() && options.study != flag) {
+                throw invalid_argument(options.study + " and " + flag + " cannot be combined; run one study at a time");
+            }
+            options.study = flag;
+            options.studySizes = parseNumbers(value, flag);
+            if (options.studySizes.empty()) {
+                throw invalid_argument("lists given on the command line must not be empty");
+            }
+        } else if (flag == "--densities") {
+            options.densities.clear();
+            for (const string &item : splitList(value)) {
+                size_t used = 0;
+                double density = -1;
+                try {
+                    density = stod(item, &used);
+                } catch (const exception &) {
+                    used = 0;
+                }
+                if (used != item.size() || !(density > 0 && density <= 1)) {
+                    throw invalid_argument("density \"" + item + "\" is not in (0, 1]");
+                }
+                options.densities.push_back(density);
+            }
+        } else if (flag == "--json") {
+            options.jsonPath = value;
+        } else if (flag == "--csv") {
+            options.csvPath = value;
+        } else {
+            throw invalid_argument("unknown option " + flag);
+        }
+    }
+
+    if (options.queries < 1 || options.repetitions < 1 || options.warmup < 0 || options.landmarks < 1) {
+        throw invalid_argument("--queries, --repetitions and --landmarks must be positive, --warmup not negative");
+    }
+    if (options.algorithms.empty() || options.graphTypes.empty() || options.sizes.empty() || options.degrees.empty()
+        || options.threads.empty() || options.densities.empty()) {
+        throw invalid_argument("lists given on the command line must not be empty");
+    }
+    return true;
+}
+
+/**
+ * @brief Entry point for benchmarking graph algorithms.
+ *
+ * Generates a seeded random graph for every combination of graph type, size,
+ * degree and weight range (or loads one graph file) and times every selected
+ * algorithm on the same random query pairs: its preprocessing once, a few
+ * untimed warm-up queries, then repeated timed passes over all pairs.
+ * Generation is timed separately from the queries. The distances of every
+ * algorithm are checked against the first one that ran on the graph.
+ * Results are printed as tables and can also be written as JSON and CSV;
+ * run with --help for the options. With --crossover it instead compares the
+ * all-pairs algorithms on graphs of growing density, with --dynamic it
+ * compares repairing a shortest-path tree after an edge update to recomputing it,
+ * with --layout it times the force-directed layout at every thread count,
+ * with --typed it compares graphs stored with narrower or wider types,
+ * with --compressed it compares compressed graphs with uncompressed ones, and
+ * with --reorder it compares node orders for cache locality.
+ */
+int main(int argc, char *argv[]) {
+    const vector<BenchmarkAlgorithm> available = benchmarkAlgorithms();
+    const vector<BenchmarkStudy> studies = benchmarkStudies();
+    BenchmarkOptions options;
+    try {
+        if (!parseOptions(argc, argv, available, studies, options)) {
+            printUsage(available, studies);
+            return 0;
+        }
+    } catch (const exception &error) {
+        cerr << error.what() << "\n\n";
+        printUsage(available, studies);
+        return 2;
+    }
+
+    // The selected algorithms, in the order of the registry
+    vector<BenchmarkAlgorithm> algorithms;
+    for (const BenchmarkAlgorithm &algorithm : available) {
+        if (find(options.algorithms.begin(), options.algorithms.end(), algorithm.name) != options.algorithms.end()) {
+            algorithms.push_back(algorithm);
+        }
+    }
+
+    vector<unique_ptr<ThreadPool>> pools;
+    for (int threads : options.threads) {
+        pools.push_back(make_unique<ThreadPool>(threads));
+    }
+    ThreadPool &loaderPool = *pools.front();
+
+    vector<BenchmarkResult> results;
+    try {
+        if (!options.study.empty()) {
+            for (const BenchmarkStudy &study : studies) {
+                if (study.flag == options.study) {
+                    study.run(options, pools);
+                }
+            }
+            return 0;
+        }
+        if (!options.file.empty()) {
+            // Loading is timed like generation; a binary graph file is only mapped
+            vector<double> loadTimes;
+            CSRGraph graph;
+            for (int repetition = 0; repetition < options.repetitions; repetition++) {
+                auto start = chrono::steady_clock::now();
+                graph = importGraph(options.file, GraphFormat::Auto, loaderPool);
+                loadTimes.push_back(secondsSince(start));
+            }
+
+            BenchmarkResult base;
+            base.graphType = "file";
+            base.generateSeconds = summarize(loadTimes).median;
+            benchmarkGraph(graph, base, algorithms, pools, options, results);
+        } else {
+            for (const string &type : options.graphTypes) {
+                for (int num_nodes : options.sizes) {
+                    for (int degree : options.degrees) {
+                        for (const auto &weights : weightRangesFor(options, type)) {
+                            vector<double> generateTimes;
+                            CSRGraph graph;
+                            for (int repetition = 0; repetition < options.repetitions; repetition++) {
+                                graph = CSRGraph();
+                                auto start = chrono::steady_clock::now();
+                                graph = type == "dag"
+                                    ? generateDAGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, loaderPool.size())
+                                    : generateDirectedGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, loaderPool.size());
+                                generateTimes.push_back(secondsSince(start));
+                            }
 
-    // Benchmark 2: Bellman-Ford on Directed Acyclic Graphs (DAGs)
-    cout << "| Nodes     | Bellman-Ford Time (s) |\n";
-    cout << "|-----------|-----------------------|\n";
-    for(int num_nodes : nodeCounts) {
-        // Generate a DAG
-        vector<vector<Edge>> graph_DAG = generateDAGraph(num_nodes, 20, -10, 10);
-        int source = 1, target = num_nodes - 1;
-
-        // Time Bellman-Ford algorithm on the DAG
-        auto startB2 = chrono::high_resolution_clock::now();
-        BellmanFord(num_nodes, source, target, graph_DAG);
-        auto endB2 = chrono::high_resolution_clock::now();
-        chrono::duration<double> durationB2 = endB2 - startB2;
-
-        // Output formatted result
-        cout << "| " << setw(10) << left << num_nodes
-             << "| " << fixed << setw(22) << setprecision(6) << durationB2.count()
-             << "|\n";
+                            BenchmarkResult base;
+                            base.graphType = type;
+                            base.degree = degree;
+                            base.generateSeconds = summarize(generateTimes).median;
+                            benchmarkGraph(graph, base, algorithms, pools, options, results);
+                        }
+                    }
+                }
+            }
+        }
 
+        if (!options.jsonPath.empty()) {
+            writeJson(options.jsonPath, options, results);
+        }
+        if (!options.csvPath.empty()) {
+            writeCsv(options.csvPath, options, results);
+        }
+    } catch (const exception &error) {
+        cerr << error.what() << "\n";
+        return 1;
     }
 
     return 0;
@@ -0,0 +1,1086 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../include/algorithm.h"
+#include "../include/allpairs.h"
+#include "../include/benchmarkstudies.h"
+#include "../include/dynamicsssp.h"
+#include "../include/forcelayout.h"
+#include "../include/perfcounters.h"
+#include "../include/reorder.h"
+#include "../include/typedgraph.h"
+using namespace std;
+
+/**
+ * @brief One row of the all-pairs crossover study: Floyd-Warshall against Johnson on a graph.
+ */
+struct CrossoverResult {
+    string graphType;
+    int nodes = 0;
+    long long edges = 0;
+    int degree = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    int threads = 1;
+    string kernel;                // the min-plus kernel of floydWarshallSeconds
+    double floydWarshallSeconds = 0;
+    double scalarSeconds = 0;     // Floyd-Warshall with the scalar kernel
+    double johnsonSeconds = 0;
+    long long mismatches = 0;     // pairs whose distances differ between the two
+    bool negativeCycle = false;   // all three found a negative cycle, so there are no distances to compare
+};
+
+/**
+ * @brief One row of the dynamic update study: the updates of a graph that touched a similar number of nodes.
+ */
+struct DynamicResult {
+    string graphType;
+    int nodes = 0;
+    long long edges = 0;
+    int degree = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    int affectedLow = 0;  // the bucket holds updates that re-labelled affectedLow..affectedHigh nodes
+    int affectedHigh = 0;
+    int updates = 0;
+    TimeSummary updateTime;   // per update, repaired by DynamicShortestPaths
+    TimeSummary recomputeTime; // per update, a full DijkstraTree on the updated graph
+    int mismatches = 0;       // updates after which the repaired tree differs from the recompute
+};
+
+/**
+ * @brief One row of the layout study: a ForceLayout run to convergence at a thread count.
+ */
+struct LayoutResult {
+    string graphType;
+    int nodes = 0;
+    long long edges = 0;
+    int degree = 0;
+    int threads = 0;
+    int iterations = 0;
+    double seconds = 0;       // the constructor and all iterations, the median of --repetitions runs
+    double speedup = 0;       // of the first thread count over this one
+    bool matches = true;      // the positions equal those of the first thread count
+};
+
+/**
+ * @brief One row of the typed graph study: a graph stored and searched with one choice of types.
+ */
+struct TypedResult {
+    string graphType;
+    int nodes = 0;
+    long long edges = 0;
+    int degree = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    string types;             // "node/weight -> distance", or "CSRGraph" for the int graph
+    string algorithm;         // dijkstra, or bellman-ford with negative weights
+    size_t bytes = 0;         // offsets, targets and weights
+    double treeSeconds = 0;   // median time of one shortest-path tree
+    int trees = 0;
+    int mismatches = 0;       // trees whose distances differ from the int graph's
+    bool saturated = false;   // some path length did not fit the distance type
+};
+
+/**
+ * @brief One row of the compression study: one representation of a graph.
+ */
+struct CompressedResult {
+    string graphType;
+    int nodes = 0;
+    long long edges = 0;
+    int degree = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    string representation;        // adjacency list, CSRGraph or CompressedGraph
+    size_t bytes = 0;
+    TimeSummary dijkstraTime;     // per query; empty with negative weights
+    TimeSummary bellmanFordTime;  // per query, over a tenth of the pairs
+    int mismatches = 0;           // queries whose distance differs from the adjacency list's
+};
+
+/**
+ * @brief One row of the reordering study: a graph with its nodes relabelled in one order.
+ */
+struct ReorderResult {
+    string graphType;
+    int nodes = 0;
+    long long edges = 0;
+    int degree = 0;
+    int minWeight = 0;
+    int maxWeight = 0;
+    string order;
+    double reorderSeconds = 0;    // computing the order and relabelling the graph
+    double edgeSpan = 0;          // mean |from - to| over the edges
+    TimeSummary dijkstraTime;     // per query; empty with negative weights
+    TimeSummary bellmanFordTime;  // per query, over a tenth of the pairs
+    double cacheReferences = -1;  // per query of the timed pass, -1 without hardware counters
+    double cacheMisses = -1;
+    double l1Misses = -1;
+    int mismatches = 0;           // queries whose distance differs from the original order's
+};
+
+// The weight ranges graphs of a type are generated with
+vector<pair<int, int>> weightRangesFor(const BenchmarkOptions &options, const string &type)
+{
+    if (!options.weightRanges.empty()) {
+        return options.weightRanges;
+    }
+    return {type == "dag" ? DAG_WEIGHTS : DIRECTED_WEIGHTS};
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const vector<double> &sorted, const double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    const size_t rank = static_cast<size_t>(ceil(p / 100.0 * sorted.size()));
+    return sorted[min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+TimeSummary summarize(vector<double> samples)
+{
+    TimeSummary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    sort(samples.begin(), samples.end());
+    double total = 0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    summary.samples = samples.size();
+    summary.median = percentile(samples, 50);
+    summary.p90 = percentile(samples, 90);
+    summary.p99 = percentile(samples, 99);
+    summary.mean = total / samples.size();
+    summary.throughput = total > 0 ? samples.size() / total : 0;
+    return summary;
+}
+
+double secondsSince(const chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+string jsonString(const string &text)
+{
+    string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            ostringstream escape;
+            escape << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c);
+            quoted += escape.str();
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+// Median time of repetitions runs of an all-pairs algorithm; keeps the result of the last run
+static double timeAllPairs(const function<AllPairsResult()> &run, const int repetitions, AllPairsResult &result)
+{
+    vector<double> times;
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        result = AllPairsResult();
+        auto start = chrono::steady_clock::now();
+        result = run();
+        times.push_back(secondsSince(start));
+    }
+    return summarize(times).median;
+}
+
+// Times Floyd-Warshall (best and scalar kernel) and Johnson on graphs of growing density, and
+// reports the degree from which Floyd-Warshall's O(n^3) beats Johnson's n Dijkstra searches
+static void runCrossover(const BenchmarkOptions &options,
+                         const vector<unique_ptr<ThreadPool>> &pools,
+                         vector<CrossoverResult> &results)
+{
+    const MinPlusKernel kernel = bestMinPlusKernel();
+    for (const string &type : options.graphTypes) {
+        for (int num_nodes : options.studySizes) {
+            for (const auto &weights : weightRangesFor(options, type)) {
+                cout << type << " graphs, " << num_nodes << " nodes, weights " << weights.first << ".." << weights.second
+                     << ", min-plus kernel " << minPlusKernelName(kernel) << "\n\n";
+                cout << "| Degree   | Edges        | Threads | FW (s)       | FW scalar (s) | Johnson (s)  | Johnson / FW | Check        |\n";
+                cout << "|----------|--------------|---------|--------------|---------------|--------------|--------------|--------------|\n";
+
+                int crossover = -1; // the smallest degree at which Floyd-Warshall won on the first thread count
+                for (double density : options.densities) {
+                    const int degree = max(1, static_cast<int>(lround(density * (num_nodes - 1))));
+                    CSRGraph graph = type == "dag"
+                        ? generateDAGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pools.front()->size())
+                        : generateDirectedGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pools.front()->size());
+
+                    for (size_t p = 0; p < pools.size(); p++) {
+                        ThreadPool &pool = *pools[p];
+                        CrossoverResult result;
+                        result.graphType = type;
+                        result.nodes = num_nodes;
+                        result.edges = graph.numEdges();
+                        result.degree = degree;
+                        result.minWeight = graph.minWeight();
+                        result.maxWeight = graph.maxWeight();
+                        result.threads = pool.size();
+                        result.kernel = minPlusKernelName(kernel);
+
+                        AllPairsResult floydWarshall, scalar, johnson;
+                        result.floydWarshallSeconds = timeAllPairs([&] { return FloydWarshall(graph, pool, kernel); },
+                                                                   options.repetitions, floydWarshall);
+                        result.scalarSeconds = timeAllPairs([&] { return FloydWarshall(graph, pool, MinPlusKernel::Scalar); },
+                                                            options.repetitions, scalar);
+                        result.johnsonSeconds = timeAllPairs([&] { return JohnsonAllPairs(graph, pool); },
+                                                             options.repetitions, johnson);
+                        // With a negative cycle the results hold no distance matrix; they only have to agree
+                        result.negativeCycle = floydWarshall.negativeCycle && scalar.negativeCycle && johnson.negativeCycle;
+                        if (floydWarshall.negativeCycle || scalar.negativeCycle || johnson.negativeCycle) {
+                            result.mismatches += !result.negativeCycle;
+                        } else {
+                            for (int from = 0; from < num_nodes; from++) {
+                                for (int to = 0; to < num_nodes; to++) {
+                                    result.mismatches += floydWarshall.distances.at(from, to) != johnson.distances.at(from, to)
+                                                         || scalar.distances.at(from, to) != johnson.distances.at(from, to);
+                                }
+                            }
+                        }
+                        if (p == 0 && crossover < 0 && result.floydWarshallSeconds < result.johnsonSeconds) {
+                            crossover = degree;
+                        }
+
+                        cout << "| " << setw(9) << left << degree << "| " << setw(13) << result.edges
+                             << "| " << setw(8) << result.threads << fixed << setprecision(6)
+                             << "| " << setw(13) << result.floydWarshallSeconds
+                             << "| " << setw(14) << result.scalarSeconds
+                             << "| " << setw(13) << result.johnsonSeconds << setprecision(2)
+                             << "| " << setw(13) << (result.floydWarshallSeconds > 0 ? result.johnsonSeconds / result.floydWarshallSeconds : 0)
+                             << "| " << setw(13) << (result.mismatches ? to_string(result.mismatches) + " differ"
+                                                     : result.negativeCycle ? string("neg. cycle") : string("ok"))
+                             << "|\n";
+                        results.push_back(result);
+                    }
+                }
+                if (crossover < 0) {
+                    cout << "\nJohnson was faster at every degree tried.\n\n\n";
+                } else {
+                    cout << "\nFloyd-Warshall was faster from average degree " << crossover << " on.\n\n\n";
+                }
+            }
+        }
+    }
+}
+
+// A random edge of the graph, or false if none was found in a few tries
+static bool randomEdge(const DynamicShortestPaths &paths, mt19937_64 &random, int &from, Edge &edge)
+{
+    uniform_int_distribution<int> node(0, paths.numNodes() - 1);
+    for (int attempt = 0; attempt < 100; attempt++) {
+        from = node(random);
+        const vector<Edge> &edges = paths.edgesOf(from);
+        if (!edges.empty()) {
+            edge = edges[uniform_int_distribution<size_t>(0, edges.size() - 1)(random)];
+            return true;
+        }
+    }
+    return false;
+}
+
+// A random edge of the shortest-path tree half the time, so that increases and deletions also hit
+// subtrees of every size, and any random edge otherwise
+static bool randomUpdateEdge(const DynamicShortestPaths &paths, mt19937_64 &random, int &from, Edge &edge)
+{
+    if (random() % 2) {
+        const int to = uniform_int_distribution<int>(0, paths.numNodes() - 1)(random);
+        from = paths.predecessor(to);
+        if (from >= 0) {
+            edge = {to, paths.weight(from, to)};
+            return true;
+        }
+    }
+    return randomEdge(paths, random, from, edge);
+}
+
+// Applies random edge decreases, increases, insertions and deletions to a shortest-path tree from
+// node 0 and times each repair against a full recompute, grouped by how many nodes the repair touched
+static void runDynamic(const BenchmarkOptions &options, const vector<unique_ptr<ThreadPool>> &pools, vector<DynamicResult> &results)
+{
+    ThreadPool &pool = *pools.front();
+    for (const string &type : options.graphTypes) {
+        for (int num_nodes : options.studySizes) {
+            for (int degree : options.degrees) {
+                for (const auto &weights : weightRangesFor(options, type)) {
+                    cout << type << " graphs, " << num_nodes << " nodes, degree " << degree << ", weights "
+                         << weights.first << ".." << weights.second << ", " << options.queries << " updates\n\n";
+                    if (weights.first < 0 || num_nodes < 1) {
+                        cout << "skipped: dynamic updates need non-negative weights and at least one node\n\n\n";
+                        continue;
+                    }
+                    CSRGraph graph = type == "dag"
+                        ? generateDAGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pool.size())
+                        : generateDirectedGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pool.size());
+                    DynamicShortestPaths paths(graph, 0);
+
+                    // Buckets of affected node counts: 0, 1-9, 10-99, ...
+                    vector<vector<double>> updateTimes, recomputeTimes;
+                    vector<int> mismatches;
+                    mt19937_64 random(options.seed);
+                    uniform_int_distribution<int> node(0, num_nodes - 1);
+                    uniform_int_distribution<int> weight(weights.first, weights.second);
+                    for (int update = 0; update < options.queries; update++) {
+                        int from = 0;
+                        Edge edge{};
+                        const int kind = random() % 4;
+                        const bool existing = kind == 0 ? randomEdge(paths, random, from, edge)
+                                              : kind != 2 && randomUpdateEdge(paths, random, from, edge);
+
+                        auto start = chrono::steady_clock::now();
+                        if (kind == 0 && existing) { // decrease
+                            paths.setWeight(from, edge.toNode, uniform_int_distribution<int>(weights.first, edge.weight)(random));
+                        } else if (kind == 1 && existing) { // increase
+                            paths.setWeight(from, edge.toNode, edge.weight + 1 + weight(random) - weights.first);
+                        } else if (kind == 3 && existing) {
+                            paths.removeEdge(from, edge.toNode);
+                        } else {
+                            paths.insertEdge(node(random), node(random), weight(random));
+                        }
+                        const double updateSeconds = secondsSince(start);
+
+                        const CSRGraph current = paths.toCSR();
+                        start = chrono::steady_clock::now();
+                        const ShortestPathTree recomputed = DijkstraTree(current, 0);
+                        const double recomputeSeconds = secondsSince(start);
+
+                        size_t bucket = 0;
+                        for (int affected = paths.affectedNodes(); affected > 0; affected /= 10) {
+                            bucket++;
+                        }
+                        if (bucket >= updateTimes.size()) {
+                            updateTimes.resize(bucket + 1);
+                            recomputeTimes.resize(bucket + 1);
+                            mismatches.resize(bucket + 1);
+                        }
+                        updateTimes[bucket].push_back(updateSeconds);
+                        recomputeTimes[bucket].push_back(recomputeSeconds);
+                        mismatches[bucket] += recomputed.distance != paths.tree().distance;
+                    }
+
+                    cout << "| Affected nodes  | Updates | Update (s)   | Recompute (s) | Recompute / update | Check        |\n";
+                    cout << "|-----------------|---------|--------------|---------------|--------------------|--------------|\n";
+                    long long low = 0, high = 0;
+                    for (size_t bucket = 0; bucket < updateTimes.size(); low = high + 1, high = high * 10 + 9, bucket++) {
+                        if (updateTimes[bucket].empty()) {
+                            continue;
+                        }
+                        DynamicResult result;
+                        result.graphType = type;
+                        result.nodes = num_nodes;
+                        result.edges = graph.numEdges();
+                        result.degree = degree;
+                        result.minWeight = graph.minWeight();
+                        result.maxWeight = graph.maxWeight();
+                        result.affectedLow = static_cast<int>(low);
+                        result.affectedHigh = static_cast<int>(min<long long>(high, num_nodes));
+                        result.updates = updateTimes[bucket].size();
+                        result.updateTime = summarize(updateTimes[bucket]);
+                        result.recomputeTime = summarize(recomputeTimes[bucket]);
+                        result.mismatches = mismatches[bucket];
+
+                        const string range = result.affectedLow == result.affectedHigh ? to_string(low) : to_string(low) + ".." + to_string(result.affectedHigh);
+                        cout << "| " << setw(16) << left << range << "| " << setw(8) << result.updates << fixed << setprecision(9)
+                             << "| " << setw(13) << result.updateTime.median
+                             << "| " << setw(14) << result.recomputeTime.median << setprecision(1)
+                             << "| " << setw(19) << (result.updateTime.median > 0 ? result.recomputeTime.median / result.updateTime.median : 0)
+                             << "| " << setw(13) << (result.mismatches ? to_string(result.mismatches) + " differ" : string("ok"))
+                             << "|\n";
+                        results.push_back(result);
+                    }
+                    cout << "\nTimes are medians per update; every recompute checks the repaired tree.\n\n\n";
+                }
+            }
+        }
+    }
+}
+
+// Runs the force-directed layout to convergence on every generated graph at every thread count
+static void runLayout(const BenchmarkOptions &options, const vector<unique_ptr<ThreadPool>> &pools, vector<LayoutResult> &results)
+{
+    for (const string &type : options.graphTypes) {
+        for (int num_nodes : options.studySizes) {
+            for (int degree : options.degrees) {
+                const auto weights = weightRangesFor(options, type).front(); // the layout ignores weights
+                cout << type << " graphs, " << num_nodes << " nodes, degree " << degree << "\n\n";
+                CSRGraph graph = type == "dag"
+                    ? generateDAGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pools.front()->size())
+                    : generateDirectedGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pools.front()->size());
+
+                cout << "| Threads | Iterations | Layout (s)   | Per iteration (ms) | Speedup | Check        |\n";
+                cout << "|---------|------------|--------------|--------------------|---------|--------------|\n";
+                vector<LayoutPoint> reference;
+                double firstSeconds = 0;
+                for (size_t p = 0; p < pools.size(); p++) {
+                    ThreadPool &pool = *pools[p];
+                    LayoutOptions layoutOptions;
+                    layoutOptions.seed = options.seed;
+                    vector<double> times;
+                    vector<LayoutPoint> positions;
+                    int iterations = 0;
+                    for (int repetition = 0; repetition < options.repetitions; repetition++) {
+                        auto start = chrono::steady_clock::now();
+                        ForceLayout layout(graph, pool, layoutOptions);
+                        while (!layout.converged()) {
+                            layout.run(layoutOptions.maxIterations);
+                        }
+                        times.push_back(secondsSince(start));
+                        iterations = layout.iteration();
+                        positions = layout.positions();
+                    }
+
+                    LayoutResult result;
+                    result.graphType = type;
+                    result.nodes = num_nodes;
+                    result.edges = graph.numEdges();
+                    result.degree = degree;
+                    result.threads = pool.size();
+                    result.iterations = iterations;
+                    result.seconds = summarize(times).median;
+                    if (p == 0) {
+                        reference = positions;
+                        firstSeconds = result.seconds;
+                    }
+                    result.speedup = result.seconds > 0 ? firstSeconds / result.seconds : 0;
+                    result.matches = equal(positions.begin(), positions.end(), reference.begin(), reference.end(),
+                                           [](const LayoutPoint &a, const LayoutPoint &b) { return a.x == b.x && a.y == b.y; });
+
+                    cout << "| " << setw(8) << left << result.threads << "| " << setw(11) << result.iterations
+                         << fixed << setprecision(6) << "| " << setw(13) << result.seconds << setprecision(3)
+                         << "| " << setw(19) << (iterations > 0 ? result.seconds * 1000 / iterations : 0) << setprecision(2)
+                         << "| " << setw(8) << result.speedup
+                         << "| " << setw(13) << (result.matches ? "ok" : "differs") << "|\n";
+                    results.push_back(result);
+                }
+                cout << "\nTimes are medians of " << options.repetitions << " runs to convergence.\n\n\n";
+            }
+        }
+    }
+}
+
+// A graph generated for the typed, compressed and reorder studies
+struct StudyGraph {
+    string type;
+    int degree = 0;
+    CSRGraph graph;
+};
+
+// Generates a graph for every graph type, study size, degree and weight range, prints its heading
+// ending in what the study runs per graph (e.g. "100 queries") and measures it. Negative weights are
+// only generated on DAGs, where Bellman-Ford cannot meet a negative cycle.
+static void forEachStudyGraph(const BenchmarkOptions &options,
+                              ThreadPool &pool,
+                              const string &perGraph,
+                              const function<void(const StudyGraph &)> &measure)
+{
+    for (const string &type : options.graphTypes) {
+        for (int num_nodes : options.studySizes) {
+            for (int degree : options.degrees) {
+                for (const auto &weights : weightRangesFor(options, type)) {
+                    cout << type << " graphs, " << num_nodes << " nodes, degree " << degree << ", weights "
+                         << weights.first << ".." << weights.second << ", " << perGraph << "\n\n";
+                    if (num_nodes < 1 || (weights.first < 0 && type != "dag")) {
+                        cout << "skipped: negative weights need a DAG, and graphs need a node\n\n\n";
+                        continue;
+                    }
+                    StudyGraph study;
+                    study.type = type;
+                    study.degree = degree;
+                    study.graph = type == "dag"
+                        ? generateDAGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pool.size())
+                        : generateDirectedGraphCSR(num_nodes, degree, weights.first, weights.second, options.seed, pool.size());
+                    measure(study);
+                }
+            }
+        }
+    }
+}
+
+// A result row with the columns that describe the study graph filled in
+template<typename Result>
+static Result studyRow(const StudyGraph &study)
+{
+    Result result;
+    result.graphType = study.type;
+    result.nodes = study.graph.numNodes();
+    result.edges = study.graph.numEdges();
+    result.degree = study.degree;
+    result.minWeight = study.graph.minWeight();
+    result.maxWeight = study.graph.maxWeight();
+    return result;
+}
+
+// count nodes drawn with the run's seed, so every representation or order of a graph gets the same ones
+static vector<int> randomNodes(const BenchmarkOptions &options, const int num_nodes, const int count)
+{
+    mt19937_64 random(options.seed);
+    uniform_int_distribution<int> node(0, num_nodes - 1);
+    vector<int> nodes(count);
+    for (int &n : nodes) {
+        n = node(random);
+    }
+    return nodes;
+}
+
+// The seeded --queries source and target pairs of a graph
+static vector<pair<int, int>> randomPairs(const BenchmarkOptions &options, const int num_nodes)
+{
+    const vector<int> nodes = randomNodes(options, num_nodes, 2 * options.queries);
+    vector<pair<int, int>> pairs(options.queries);
+    for (size_t i = 0; i < pairs.size(); i++) {
+        pairs[i] = {nodes[2 * i], nodes[2 * i + 1]};
+    }
+    return pairs;
+}
+
+// Bellman-Ford only runs this many of the pairs, the first tenth
+static size_t bellmanFordPairs(const vector<pair<int, int>> &pairs)
+{
+    return max<size_t>(1, pairs.size() / 10);
+}
+
+// Times query on each of the first count pairs. The first row of a graph fills the empty reference
+// with its distances; later rows add the queries whose distance differs from it to mismatches
+static TimeSummary timeQueries(const vector<pair<int, int>> &pairs,
+                               const size_t count,
+                               const function<int(int, int)> &query,
+                               vector<int> &reference,
+                               int &mismatches)
+{
+    const bool record = reference.empty();
+    vector<double> times;
+    for (size_t i = 0; i < count; i++) {
+        auto start = chrono::steady_clock::now();
+        const int distance = query(pairs[i].first, pairs[i].second);
+        times.push_back(secondsSince(start));
+        if (record) {
+            reference.push_back(distance);
+        } else {
+            mismatches += distance != reference[i];
+        }
+    }
+    return summarize(times);
+}
+
+// Bytes of the int offsets, targets and weights of a CSRGraph
+static size_t csrBytes(const CSRGraph &graph)
+{
+    return (static_cast<size_t>(graph.numNodes()) + 1 + 2 * static_cast<size_t>(graph.numEdges())) * sizeof(int);
+}
+
+// Times the shortest-path trees from sources on graph stored as BasicCSRGraph<NodeId, Weight> with
+// Distance sums and compares their distances to the int graph's trees in reference
+template<typename NodeId, typename Weight, typename Distance>
+static bool timeTyped(const string &types, const CSRGraph &graph, const vector<int> &sources,
+                      const vector<ShortestPathTree> &reference, TypedResult result, vector<TypedResult> &results)
+{
+    if (!BasicCSRGraph<NodeId, Weight>::fits(graph)) {
+        return false;
+    }
+    const auto typed = BasicCSRGraph<NodeId, Weight>::fromCSR(graph);
+    const bool negative = graph.minWeight() < 0;
+    vector<double> times;
+    for (size_t i = 0; i < sources.size(); i++) {
+        const NodeId source = static_cast<NodeId>(sources[i]);
+        auto start = chrono::steady_clock::now();
+        const auto tree = negative ? BellmanFordTree<Distance>(typed, source) : DijkstraTree<Distance>(typed, source);
+        times.push_back(secondsSince(start));
+        result.saturated = result.saturated || tree.saturated;
+        for (int v = 0; v < graph.numNodes(); v++) {
+            const bool unreachable = reference[i].distance[v] == numeric_limits<int>::max();
+            if (unreachable != (tree.distance[v] == tree.unreachable())
+                || (!unreachable && tree.distance[v] != static_cast<Distance>(reference[i].distance[v]))) {
+                result.mismatches++;
+                break;
+            }
+        }
+    }
+    result.types = types;
+    result.bytes = typed.memoryBytes();
+    result.treeSeconds = summarize(times).median;
+    result.trees = sources.size();
+    results.push_back(result);
+    return true;
+}
+
+// Stores every generated graph with narrower or wider node id, weight and distance types and
+// compares memory and shortest-path tree time with the int CSRGraph
+static void runTyped(const BenchmarkOptions &options, const vector<unique_ptr<ThreadPool>> &pools, vector<TypedResult> &results)
+{
+    forEachStudyGraph(options, *pools.front(), to_string(options.repetitions) + " trees", [&](const StudyGraph &study) {
+        const CSRGraph &graph = study.graph;
+        const bool negative = graph.minWeight() < 0;
+
+        // The int graph gives the reference trees and the first row
+        const vector<int> sources = randomNodes(options, graph.numNodes(), options.repetitions);
+        vector<ShortestPathTree> reference;
+        vector<double> times;
+        for (int source : sources) {
+            auto start = chrono::steady_clock::now();
+            reference.push_back(negative ? BellmanFordTree(graph, source) : DijkstraTree(graph, source));
+            times.push_back(secondsSince(start));
+        }
+
+        TypedResult base = studyRow<TypedResult>(study);
+        base.algorithm = negative ? "bellman-ford" : "dijkstra";
+        TypedResult intGraph = base;
+        intGraph.types = "CSRGraph";
+        intGraph.bytes = csrBytes(graph);
+        intGraph.treeSeconds = summarize(times).median;
+        intGraph.trees = options.repetitions;
+        const size_t first = results.size();
+        results.push_back(intGraph);
+
+        // Narrow weights only where the graph's weights fit them
+        vector<string> skipped;
+        auto run = [&](const string &types, bool fitted) {
+            if (!fitted) {
+                skipped.push_back(types);
+            }
+        };
+        run("int32/int32 -> int32", timeTyped<int32_t, int32_t, int32_t>("int32/int32 -> int32", graph, sources, reference, base, results));
+        run("int32/int32 -> int64", timeTyped<int32_t, int32_t, int64_t>("int32/int32 -> int64", graph, sources, reference, base, results));
+        run("uint32/int8 -> int32", timeTyped<uint32_t, int8_t, int32_t>("uint32/int8 -> int32", graph, sources, reference, base, results));
+        run("uint32/int8 -> int64", timeTyped<uint32_t, int8_t, int64_t>("uint32/int8 -> int64", graph, sources, reference, base, results));
+        run("uint32/int16 -> int32", timeTyped<uint32_t, int16_t, int32_t>("uint32/int16 -> int32", graph, sources, reference, base, results));
+        run("uint32/int16 -> int64", timeTyped<uint32_t, int16_t, int64_t>("uint32/int16 -> int64", graph, sources, reference, base, results));
+        run("uint32/int32 -> int64", timeTyped<uint32_t, int32_t, int64_t>("uint32/int32 -> int64", graph, sources, reference, base, results));
+        run("uint32/float -> float", timeTyped<uint32_t, float, float>("uint32/float -> float", graph, sources, reference, base, results));
+        run("uint32/float -> double", timeTyped<uint32_t, float, double>("uint32/float -> double", graph, sources, reference, base, results));
+
+        cout << "| Types                   | Memory (MB) | Bytes / edge | Tree (s)     | Speedup | Check        |\n";
+        cout << "|-------------------------|-------------|--------------|--------------|---------|--------------|\n";
+        for (size_t i = first; i < results.size(); i++) {
+            const TypedResult &r = results[i];
+            cout << "| " << setw(24) << left << r.types << fixed << setprecision(3)
+                 << "| " << setw(12) << r.bytes / 1e6 << setprecision(2)
+                 << "| " << setw(13) << (r.edges > 0 ? static_cast<double>(r.bytes) / r.edges : 0) << setprecision(6)
+                 << "| " << setw(13) << r.treeSeconds << setprecision(2)
+                 << "| " << setw(8) << (r.treeSeconds > 0 ? intGraph.treeSeconds / r.treeSeconds : 0)
+                 << "| " << setw(13) << (r.mismatches ? to_string(r.mismatches) + " differ" : r.saturated ? string("saturated") : string("ok"))
+                 << "|\n";
+        }
+        cout << "\nTimes are medians of " << options.repetitions << " " << base.algorithm
+             << " trees; every tree is checked against the CSRGraph one.\n";
+        if (graph.minWeight() >= 1 && graph.maxWeight() <= BUCKET_QUEUE_MAX_WEIGHT) {
+            cout << "The CSRGraph trees use a bucket queue for this small weight range, the typed ones a binary heap.\n";
+        }
+        for (const string &types : skipped) {
+            cout << types << ": skipped, the weights do not fit\n";
+        }
+        cout << "\n\n";
+    });
+}
+
+// Compares Dijkstra and Bellman-Ford queries on the adjacency list, the CSR graph and the compressed
+// graph of every generated graph, together with the bytes each representation takes per edge
+static void runCompressed(const BenchmarkOptions &options, const vector<unique_ptr<ThreadPool>> &pools, vector<CompressedResult> &results)
+{
+    forEachStudyGraph(options, *pools.front(), to_string(options.queries) + " queries", [&](const StudyGraph &study) {
+        const CSRGraph &graph = study.graph;
+        const int num_nodes = graph.numNodes();
+        const vector<vector<Edge>> adjacencyList = graph.toAdjacencyList();
+        const CompressedGraph compressed(graph);
+        const bool negative = graph.minWeight() < 0;
+        const vector<pair<int, int>> pairs = randomPairs(options, num_nodes);
+
+        // The adjacency list comes first and gives the reference distances
+        const size_t first = results.size();
+        vector<int> dijkstraDistances, bellmanFordDistances;
+        auto measure = [&](const string &representation, size_t bytes,
+                           const function<int(int, int)> &dijkstra, const function<int(int, int)> &bellmanFord) {
+            CompressedResult result = studyRow<CompressedResult>(study);
+            result.representation = representation;
+            result.bytes = bytes;
+            result.dijkstraTime = timeQueries(pairs, negative ? 0 : pairs.size(), dijkstra, dijkstraDistances, result.mismatches);
+            result.bellmanFordTime = timeQueries(pairs, bellmanFordPairs(pairs), bellmanFord, bellmanFordDistances, result.mismatches);
+            results.push_back(result);
+        };
+
+        size_t listBytes = adjacencyList.capacity() * sizeof(vector<Edge>);
+        for (const auto &edges : adjacencyList) {
+            listBytes += edges.capacity() * sizeof(Edge);
+        }
+        measure("adjacency list", listBytes,
+                [&](int s, int t) { return Dijkstra(num_nodes, s, t, adjacencyList).second; },
+                [&](int s, int t) { return BellmanFord(num_nodes, s, t, adjacencyList).second; });
+        measure("CSRGraph", csrBytes(graph),
+                [&](int s, int t) { return DijkstraHeap(num_nodes, s, t, graph).second; },
+                [&](int s, int t) { return BellmanFord(num_nodes, s, t, graph).second; });
+        measure("CompressedGraph", compressed.memoryBytes(),
+                [&](int s, int t) { return Dijkstra(num_nodes, s, t, compressed).second; },
+                [&](int s, int t) { return BellmanFord(num_nodes, s, t, compressed).second; });
+
+        cout << "| Representation   | Bytes / edge | Dijkstra (s) | Queries / s  | Bellman-Ford (s) | Check        |\n";
+        cout << "|------------------|--------------|--------------|--------------|------------------|--------------|\n";
+        for (size_t i = first; i < results.size(); i++) {
+            const CompressedResult &r = results[i];
+            cout << "| " << setw(17) << left << r.representation << fixed << setprecision(2)
+                 << "| " << setw(13) << (r.edges > 0 ? static_cast<double>(r.bytes) / r.edges : 0) << setprecision(6)
+                 << "| " << setw(13) << r.dijkstraTime.median << setprecision(1)
+                 << "| " << setw(13) << r.dijkstraTime.throughput << setprecision(6)
+                 << "| " << setw(17) << r.bellmanFordTime.median
+                 << "| " << setw(13) << (r.mismatches ? to_string(r.mismatches) + " differ" : string("ok")) << "|\n";
+        }
+        cout << "\nWeights packed into " << compressed.weightBits() << " bits. Times are medians per query; "
+             << "Bellman-Ford runs " << bellmanFordPairs(pairs) << " of the pairs" << (negative ? ", Dijkstra none (negative weights)" : "")
+             << ". Distances are checked against the adjacency list.\n\n\n";
+    });
+}
+
+// Relabels every generated graph in each node order and times queries in original ids on it,
+// counting cache misses over the timed queries where the hardware counters can be read
+static void runReorder(const BenchmarkOptions &options, const vector<unique_ptr<ThreadPool>> &pools, vector<ReorderResult> &results)
+{
+    PerfCounters counters;
+    if (!counters.available()) {
+        cout << "Cache counters not available (" << counters.error() << "); reporting times and edge spans only.\n\n";
+    }
+    forEachStudyGraph(options, *pools.front(), to_string(options.queries) + " queries", [&](const StudyGraph &study) {
+        const CSRGraph &graph = study.graph;
+        const bool negative = graph.minWeight() < 0;
+        const vector<pair<int, int>> pairs = randomPairs(options, graph.numNodes());
+
+        // The original order comes first and gives the reference distances
+        const size_t first = results.size();
+        vector<int> dijkstraDistances, bellmanFordDistances;
+        for (NodeOrder order : {NodeOrder::Original, NodeOrder::BFS, NodeOrder::ReverseCuthillMcKee, NodeOrder::Degree}) {
+            ReorderResult result = studyRow<ReorderResult>(study);
+            result.order = nodeOrderName(order);
+
+            auto start = chrono::steady_clock::now();
+            const ReorderedGraph reordered(graph, order);
+            result.reorderSeconds = secondsSince(start);
+            result.edgeSpan = reordered.meanEdgeSpan();
+
+            // Counted over the Dijkstra queries, or the Bellman-Ford ones with negative weights
+            counters.start();
+            result.dijkstraTime = timeQueries(pairs, negative ? 0 : pairs.size(),
+                                              [&](int s, int t) { return reordered.dijkstra(s, t).second; },
+                                              dijkstraDistances, result.mismatches);
+            if (!negative) {
+                counters.stop();
+            }
+            result.bellmanFordTime = timeQueries(pairs, bellmanFordPairs(pairs),
+                                                 [&](int s, int t) { return reordered.bellmanFord(s, t).second; },
+                                                 bellmanFordDistances, result.mismatches);
+            if (negative) {
+                counters.stop();
+            }
+            if (counters.available() && counters.cacheMisses() >= 0) {
+                const double counted = negative ? bellmanFordPairs(pairs) : pairs.size();
+                result.cacheReferences = counters.cacheReferences() / counted;
+                result.cacheMisses = counters.cacheMisses() / counted;
+                result.l1Misses = counters.l1ReadMisses() / counted;
+            }
+            results.push_back(result);
+        }
+
+        cout << "| Order    | Reorder (s) | Edge span   | Dijkstra (s) | Queries / s  | Bellman-Ford (s) | LLC misses / q | L1 misses / q  | Check        |\n";
+        cout << "|----------|-------------|-------------|--------------|--------------|------------------|----------------|----------------|--------------|\n";
+        for (size_t i = first; i < results.size(); i++) {
+            const ReorderResult &r = results[i];
+            cout << "| " << setw(9) << left << r.order << fixed << setprecision(6)
+                 << "| " << setw(12) << r.reorderSeconds << setprecision(1)
+                 << "| " << setw(12) << r.edgeSpan << setprecision(6)
+                 << "| " << setw(13) << r.dijkstraTime.median << setprecision(1)
+                 << "| " << setw(13) << r.dijkstraTime.throughput << setprecision(6)
+                 << "| " << setw(17) << r.bellmanFordTime.median << setprecision(0)
+                 << "| " << setw(15) << (r.cacheMisses >= 0 ? to_string(llround(r.cacheMisses)) : string("n/a"))
+                 << "| " << setw(15) << (r.l1Misses >= 0 ? to_string(llround(r.l1Misses)) : string("n/a"))
+                 << "| " << setw(13) << (r.mismatches ? to_string(r.mismatches) + " differ" : string("ok")) << "|\n";
+        }
+        cout << "\nTimes are medians per query in original ids; Bellman-Ford runs " << bellmanFordPairs(pairs)
+             << " of the pairs" << (negative ? ", Dijkstra none (negative weights)" : "")
+             << ". Edge span is the mean |from - to| of the relabelled edges. Distances are checked against the original order.\n\n\n";
+    });
+}
+
+static void writeCrossoverJson(const string &path, const BenchmarkOptions &options, const vector<CrossoverResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"repetitions\": " << options.repetitions << "},\n";
+    out << "  \"crossover\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const CrossoverResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graphType) << ", \"nodes\": " << r.nodes
+            << ", \"edges\": " << r.edges << ", \"degree\": " << r.degree << ", \"min_weight\": " << r.minWeight
+            << ", \"max_weight\": " << r.maxWeight << ", \"threads\": " << r.threads
+            << ", \"kernel\": " << jsonString(r.kernel) << ", \"floyd_warshall_s\": " << r.floydWarshallSeconds
+            << ", \"floyd_warshall_scalar_s\": " << r.scalarSeconds << ", \"johnson_s\": " << r.johnsonSeconds
+            << ", \"mismatches\": " << r.mismatches << ", \"negative_cycle\": " << (r.negativeCycle ? "true" : "false") << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeCrossoverCsv(const string &path, const vector<CrossoverResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "graph,nodes,edges,degree,min_weight,max_weight,threads,kernel,floyd_warshall_s,floyd_warshall_scalar_s,"
+           "johnson_s,mismatches,negative_cycle\n";
+    for (const CrossoverResult &r : results) {
+        out << r.graphType << ',' << r.nodes << ',' << r.edges << ',' << r.degree << ',' << r.minWeight << ','
+            << r.maxWeight << ',' << r.threads << ',' << r.kernel << ',' << r.floydWarshallSeconds << ','
+            << r.scalarSeconds << ',' << r.johnsonSeconds << ',' << r.mismatches << ',' << r.negativeCycle << '\n';
+    }
+}
+
+static void writeDynamicJson(const string &path, const BenchmarkOptions &options, const vector<DynamicResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"updates\": " << options.queries << "},\n";
+    out << "  \"dynamic\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const DynamicResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graphType) << ", \"nodes\": " << r.nodes
+            << ", \"edges\": " << r.edges << ", \"degree\": " << r.degree << ", \"min_weight\": " << r.minWeight
+            << ", \"max_weight\": " << r.maxWeight << ", \"affected_low\": " << r.affectedLow
+            << ", \"affected_high\": " << r.affectedHigh << ", \"updates\": " << r.updates
+            << ", \"update_median_s\": " << r.updateTime.median << ", \"update_p90_s\": " << r.updateTime.p90
+            << ", \"recompute_median_s\": " << r.recomputeTime.median << ", \"recompute_p90_s\": " << r.recomputeTime.p90
+            << ", \"mismatches\": " << r.mismatches << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeDynamicCsv(const string &path, const vector<DynamicResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "graph,nodes,edges,degree,min_weight,max_weight,affected_low,affected_high,updates,update_median_s,"
+           "update_p90_s,recompute_median_s,recompute_p90_s,mismatches\n";
+    for (const DynamicResult &r : results) {
+        out << r.graphType << ',' << r.nodes << ',' << r.edges << ',' << r.degree << ',' << r.minWeight << ','
+            << r.maxWeight << ',' << r.affectedLow << ',' << r.affectedHigh << ',' << r.updates << ','
+            << r.updateTime.median << ',' << r.updateTime.p90 << ',' << r.recomputeTime.median << ','
+            << r.recomputeTime.p90 << ',' << r.mismatches << '\n';
+    }
+}
+
+static void writeLayoutJson(const string &path, const BenchmarkOptions &options, const vector<LayoutResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"repetitions\": " << options.repetitions << "},\n";
+    out << "  \"layout\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const LayoutResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graphType) << ", \"nodes\": " << r.nodes
+            << ", \"edges\": " << r.edges << ", \"degree\": " << r.degree << ", \"threads\": " << r.threads
+            << ", \"iterations\": " << r.iterations << ", \"layout_s\": " << r.seconds
+            << ", \"speedup\": " << r.speedup << ", \"matches\": " << (r.matches ? "true" : "false") << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeLayoutCsv(const string &path, const vector<LayoutResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "graph,nodes,edges,degree,threads,iterations,layout_s,speedup,matches\n";
+    for (const LayoutResult &r : results) {
+        out << r.graphType << ',' << r.nodes << ',' << r.edges << ',' << r.degree << ',' << r.threads << ','
+            << r.iterations << ',' << r.seconds << ',' << r.speedup << ',' << (r.matches ? 1 : 0) << '\n';
+    }
+}
+
+static void writeTypedJson(const string &path, const BenchmarkOptions &options, const vector<TypedResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"repetitions\": " << options.repetitions << "},\n";
+    out << "  \"typed\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const TypedResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graphType) << ", \"nodes\": " << r.nodes
+            << ", \"edges\": " << r.edges << ", \"degree\": " << r.degree << ", \"min_weight\": " << r.minWeight
+            << ", \"max_weight\": " << r.maxWeight << ", \"types\": " << jsonString(r.types)
+            << ", \"algorithm\": " << jsonString(r.algorithm) << ", \"bytes\": " << r.bytes
+            << ", \"tree_median_s\": " << r.treeSeconds << ", \"trees\": " << r.trees
+            << ", \"mismatches\": " << r.mismatches << ", \"saturated\": " << (r.saturated ? "true" : "false") << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeTypedCsv(const string &path, const vector<TypedResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "graph,nodes,edges,degree,min_weight,max_weight,types,algorithm,bytes,tree_median_s,trees,mismatches,saturated\n";
+    for (const TypedResult &r : results) {
+        out << r.graphType << ',' << r.nodes << ',' << r.edges << ',' << r.degree << ',' << r.minWeight << ','
+            << r.maxWeight << ',' << r.types << ',' << r.algorithm << ',' << r.bytes << ',' << r.treeSeconds << ','
+            << r.trees << ',' << r.mismatches << ',' << (r.saturated ? 1 : 0) << '\n';
+    }
+}
+
+static void writeCompressedJson(const string &path, const BenchmarkOptions &options, const vector<CompressedResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"queries\": " << options.queries << "},\n";
+    out << "  \"compressed\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const CompressedResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graphType) << ", \"nodes\": " << r.nodes
+            << ", \"edges\": " << r.edges << ", \"degree\": " << r.degree << ", \"min_weight\": " << r.minWeight
+            << ", \"max_weight\": " << r.maxWeight << ", \"representation\": " << jsonString(r.representation)
+            << ", \"bytes\": " << r.bytes << ", \"dijkstra_median_s\": " << r.dijkstraTime.median
+            << ", \"dijkstra_qps\": " << r.dijkstraTime.throughput
+            << ", \"bellman_ford_median_s\": " << r.bellmanFordTime.median
+            << ", \"mismatches\": " << r.mismatches << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeCompressedCsv(const string &path, const vector<CompressedResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "graph,nodes,edges,degree,min_weight,max_weight,representation,bytes,dijkstra_median_s,dijkstra_qps,"
+           "bellman_ford_median_s,mismatches\n";
+    for (const CompressedResult &r : results) {
+        out << r.graphType << ',' << r.nodes << ',' << r.edges << ',' << r.degree << ',' << r.minWeight << ','
+            << r.maxWeight << ',' << r.representation << ',' << r.bytes << ',' << r.dijkstraTime.median << ','
+            << r.dijkstraTime.throughput << ',' << r.bellmanFordTime.median << ',' << r.mismatches << '\n';
+    }
+}
+
+static void writeReorderJson(const string &path, const BenchmarkOptions &options, const vector<ReorderResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "{\n  \"config\": {\"seed\": " << options.seed << ", \"queries\": " << options.queries << "},\n";
+    out << "  \"reorder\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const ReorderResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"graph\": " << jsonString(r.graphType) << ", \"nodes\": " << r.nodes
+            << ", \"edges\": " << r.edges << ", \"degree\": " << r.degree << ", \"min_weight\": " << r.minWeight
+            << ", \"max_weight\": " << r.maxWeight << ", \"order\": " << jsonString(r.order)
+            << ", \"reorder_s\": " << r.reorderSeconds << ", \"edge_span\": " << r.edgeSpan
+            << ", \"dijkstra_median_s\": " << r.dijkstraTime.median << ", \"dijkstra_qps\": " << r.dijkstraTime.throughput
+            << ", \"bellman_ford_median_s\": " << r.bellmanFordTime.median
+            << ", \"cache_references_per_query\": " << r.cacheReferences << ", \"cache_misses_per_query\": " << r.cacheMisses
+            << ", \"l1_misses_per_query\": " << r.l1Misses << ", \"mismatches\": " << r.mismatches << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeReorderCsv(const string &path, const vector<ReorderResult> &results)
+{
+    ofstream out(path);
+    if (!out) {
+        throw runtime_error("cannot write " + path);
+    }
+    out << setprecision(9);
+    out << "graph,nodes,edges,degree,min_weight,max_weight,order,reorder_s,edge_span,dijkstra_median_s,dijkstra_qps,"
+           "bellman_ford_median_s,cache_references_per_query,cache_misses_per_query,l1_misses_per_query,mismatches\n";
+    for (const ReorderResult &r : results) {
+        out << r.graphType << ',' << r.nodes << ',' << r.edges << ',' << r.degree << ',' << r.minWeight << ','
+            << r.maxWeight << ',' << r.order << ',' << r.reorderSeconds << ',' << r.edgeSpan << ','
+            << r.dijkstraTime.median << ',' << r.dijkstraTime.throughput << ',' << r.bellmanFordTime.median << ','
+            << r.cacheReferences << ',' << r.cacheMisses << ',' << r.l1Misses << ',' << r.mismatches << '\n';
+    }
+}
+
+// A study entry that collects the rows of run and writes them with the study's writers
+template<typename Result>
+static BenchmarkStudy makeStudy(const string &flag,
+                                const string &usage,
+                                void (*run)(const BenchmarkOptions &, const vector<unique_ptr<ThreadPool>> &, vector<Result> &),
+                                void (*writeJsonFile)(const string &, const BenchmarkOptions &, const vector<Result> &),
+                                void (*writeCsvFile)(const string &, const vector<Result> &))
+{
+    return {flag, usage, [=](const BenchmarkOptions &options, const vector<unique_ptr<ThreadPool>> &pools) {
+        vector<Result> results;
+        run(options, pools, results);
+        if (!options.jsonPath.empty()) {
+            writeJsonFile(options.jsonPath, options, results);
+        }
+        if (!options.csvPath.empty()) {
+            writeCsvFile(options.csvPath, results);
+        }
+    }};
+}
+
+// The studies the harness knows, in the order of the help text
+vector<BenchmarkStudy> benchmarkStudies()
+{
+    return {
+        makeStudy<CrossoverResult>("--crossover", "time all-pairs Floyd-Warshall against Johnson on\n"
+                                                  "graphs of these node counts and growing --densities",
+                                   runCrossover, writeCrossoverJson, writeCrossoverCsv),
+        makeStudy<DynamicResult>("--dynamic", "time --queries random edge updates of a shortest-path\n"
+                                              "tree against full recomputes on graphs of these node counts",
+                                 runDynamic, writeDynamicJson, writeDynamicCsv),
+        makeStudy<LayoutResult>("--layout", "time the force-directed layout at every --threads\n"
+                                            "count on graphs of these node counts",
+                                runLayout, writeLayoutJson, writeLayoutCsv),
+        makeStudy<TypedResult>("--typed", "compare the memory and shortest-path tree time of the\n"
+                                          "typed graph instantiations on graphs of these node counts",
+                               runTyped, writeTypedJson, writeTypedCsv),
+        makeStudy<CompressedResult>("--compressed", "compare bytes per edge and query time of adjacency lists,\n"
+                                                    "CSR graphs and compressed graphs of these node counts",
+                                    runCompressed, writeCompressedJson, writeCompressedCsv),
+        makeStudy<ReorderResult>("--reorder", "compare queries on graphs of these node counts relabelled\n"
+                                              "in BFS, Reverse Cuthill-McKee and degree order, with cache counters",
+                                 runReorder, writeReorderJson, writeReorderCsv),
+    };
+}
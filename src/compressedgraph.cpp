@@ -0,0 +1,92 @@
+#include "../include/compressedgraph.h"
+#include <algorithm>
+using namespace std;
+
+constexpr uint32_t CompressedGraph::LENGTH_MASKS[4];
+
+// Bytes after the last value, so that every delta and weight can be read with one full-width load
+static const size_t STREAM_PADDING = 8;
+
+// Bytes needed for a delta: 1 to 4
+static unsigned byteLength(const uint32_t value)
+{
+    return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+
+CompressedGraph::CompressedGraph(const CSRGraph &graph)
+    : nodeCount(graph.numNodes())
+    , minEdgeWeight(graph.minWeight())
+    , maxEdgeWeight(graph.maxWeight())
+    , topological(graph.isTopologicallyOrdered())
+{
+    const int edges = graph.numEdges();
+    const uint64_t range = static_cast<uint64_t>(static_cast<long long>(maxEdgeWeight) - minEdgeWeight);
+    while (bitsPerWeight < 32 && (range >> bitsPerWeight) != 0) {
+        bitsPerWeight++;
+    }
+    weightMask = (uint64_t(1) << bitsPerWeight) - 1;
+
+    edgeOffsets.assign(graph.offsetsData(), graph.offsetsData() + nodeCount + 1);
+    streamOffsets.resize(nodeCount + 1);
+    packedWeights.assign((static_cast<uint64_t>(edges) * bitsPerWeight + 7) / 8 + STREAM_PADDING, 0);
+    targetStream.reserve(edges + edges / 4 + STREAM_PADDING); // about one byte per delta plus the control bytes
+
+    vector<pair<int, int>> sorted; // (target, weight) of one node
+    uint32_t deltas[4];
+    for (int node = 0; node < nodeCount; node++) {
+        streamOffsets[node] = targetStream.size();
+        sorted.clear();
+        for (int e = graph.edgesBegin(node); e < graph.edgesEnd(node); e++) {
+            sorted.emplace_back(graph.target(e), graph.weight(e));
+        }
+        sort(sorted.begin(), sorted.end());
+
+        for (size_t i = 0; i < sorted.size(); i += 4) {
+            const size_t count = min<size_t>(4, sorted.size() - i);
+            unsigned control = 0;
+            for (size_t j = 0; j < count; j++) {
+                if (i + j == 0) {
+                    const int32_t first = sorted[0].first - node;
+                    deltas[j] = (static_cast<uint32_t>(first) << 1) ^ static_cast<uint32_t>(first >> 31); // zigzag
+                } else {
+                    deltas[j] = static_cast<uint32_t>(sorted[i + j].first - sorted[i + j - 1].first);
+                }
+                control |= (byteLength(deltas[j]) - 1) << (2 * j);
+            }
+            targetStream.push_back(static_cast<uint8_t>(control));
+            for (size_t j = 0; j < count; j++) {
+                for (unsigned b = 0; b < byteLength(deltas[j]); b++) {
+                    targetStream.push_back(static_cast<uint8_t>(deltas[j] >> (8 * b)));
+                }
+            }
+        }
+
+        // Weights in the sorted order, at the same edge index
+        for (size_t i = 0; i < sorted.size(); i++) {
+            const uint64_t value = static_cast<uint64_t>(static_cast<long long>(sorted[i].second) - minEdgeWeight);
+            const uint64_t bit = static_cast<uint64_t>(edgeOffsets[node] + i) * bitsPerWeight;
+            for (int b = 0; b < bitsPerWeight; b++) {
+                if ((value >> b) & 1) {
+                    packedWeights[(bit + b) / 8] |= static_cast<uint8_t>(1u << ((bit + b) % 8));
+                }
+            }
+        }
+    }
+    streamOffsets[nodeCount] = targetStream.size();
+    targetStream.resize(targetStream.size() + STREAM_PADDING, 0);
+    targetStream.shrink_to_fit();
+}
+
+CSRGraph CompressedGraph::toCSR() const
+{
+    vector<int> targets, weights;
+    targets.reserve(numEdges());
+    weights.reserve(numEdges());
+    for (int node = 0; node < nodeCount; node++) {
+        forEachEdge(node, [&](int toNode, int weight) {
+            targets.push_back(toNode);
+            weights.push_back(weight);
+        });
+    }
+    return CSRGraph(edgeOffsets.empty() ? vector<int>{0} : edgeOffsets, std::move(targets), std::move(weights), topological);
+}
@@ -0,0 +1,448 @@
+#include "../include/contractionhierarchy.h"
+#include <algorithm>
+#include <limits>
+#include <queue>
+using namespace std;
+
+ContractionHierarchy::ContractionHierarchy(const vector<vector<Edge>> &adjacencyList,
+                                           int witnessSettleLimit,
+                                           double coreDegreeLimit)
+{
+    build(CSRGraph(adjacencyList), witnessSettleLimit, coreDegreeLimit);
+}
+
+ContractionHierarchy::ContractionHierarchy(const CSRGraph &graph,
+                                           int witnessSettleLimit,
+                                           double coreDegreeLimit)
+{
+    build(graph, witnessSettleLimit, coreDegreeLimit);
+}
+
+void ContractionHierarchy::build(const CSRGraph &graph, const int witnessSettleLimit, const double coreDegreeLimit)
+{
+    const int INF = numeric_limits<int>::max();
+    const int num_nodes = graph.numNodes();
+
+    // Remaining (uncontracted) graph; out[v] and in[v] only list uncontracted neighbors
+    vector<vector<CHEdge>> out(num_nodes), in(num_nodes);
+    long long remainingEdges = 0;
+
+    // Copy the graph, dropping self-loops and keeping only the lightest of parallel edges
+    for (int u = 0; u < num_nodes; u++) {
+        graph.forEachEdge(u, [&](int toNode, int weight) {
+            if (toNode != u) {
+                out[u].push_back({toNode, weight, -1});
+            }
+        });
+        sort(out[u].begin(), out[u].end(), [](const CHEdge &a, const CHEdge &b) {
+            return a.node != b.node ? a.node < b.node : a.weight < b.weight;
+        });
+        out[u].erase(unique(out[u].begin(), out[u].end(), [](const CHEdge &a, const CHEdge &b) {
+            return a.node == b.node;
+        }), out[u].end());
+        for (const CHEdge &edge : out[u]) {
+            in[edge.node].push_back({u, edge.weight, -1});
+        }
+        remainingEdges += out[u].size();
+    }
+
+    // Adds u -> x (or lowers its weight) in the remaining graph
+    auto addShortcut = [&](int u, int x, int weight, int middle) {
+        for (CHEdge &edge : out[u]) {
+            if (edge.node == x) {
+                if (edge.weight > weight) {
+                    edge.weight = weight;
+                    edge.middle = middle;
+                    for (CHEdge &reverseEdge : in[x]) {
+                        if (reverseEdge.node == u) {
+                            reverseEdge.weight = weight;
+                            reverseEdge.middle = middle;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        out[u].push_back({x, weight, middle});
+        in[x].push_back({u, weight, middle});
+        remainingEdges++;
+    };
+
+    // Witness search state, reset through the touched list
+    vector<int> witnessDistance(num_nodes, INF);
+    vector<int> witnessTouched;
+
+    // Bounded Dijkstra from u in the remaining graph without the node being contracted
+    auto witnessSearch = [&](int u, int skip, int maxDist) {
+        for (int node : witnessTouched) {
+            witnessDistance[node] = INF;
+        }
+        witnessTouched.clear();
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+        witnessDistance[u] = 0;
+        witnessTouched.push_back(u);
+        pq.emplace(0, u);
+        int settled = 0;
+
+        while (!pq.empty() && settled < witnessSettleLimit) {
+            pair<int, int> top_node = pq.top();
+            pq.pop();
+            if (top_node.first > witnessDistance[top_node.second]) {
+                continue;
+            }
+            if (top_node.first > maxDist) {
+                break;
+            }
+            settled++;
+
+            for (const CHEdge &edge : out[top_node.second]) {
+                if (edge.node == skip) {
+                    continue;
+                }
+                int newDist = top_node.first + edge.weight;
+                if (newDist < witnessDistance[edge.node]) {
+                    if (witnessDistance[edge.node] == INF) {
+                        witnessTouched.push_back(edge.node);
+                    }
+                    witnessDistance[edge.node] = newDist;
+                    pq.emplace(newDist, edge.node);
+                }
+            }
+        }
+    };
+
+    // Adds the shortcuts needed to contract v
+    auto contractNode = [&](int v) {
+        for (size_t i = 0; i < in[v].size(); i++) {
+            const CHEdge incoming = in[v][i]; // copy: adding shortcuts may reallocate lists
+            int maxDist = 0;
+            for (const CHEdge &outgoing : out[v]) {
+                if (outgoing.node != incoming.node) {
+                    maxDist = max(maxDist, incoming.weight + outgoing.weight);
+                }
+            }
+            if (maxDist == 0 && out[v].empty()) {
+                break;
+            }
+
+            witnessSearch(incoming.node, v, maxDist);
+
+            for (size_t j = 0; j < out[v].size(); j++) {
+                const CHEdge outgoing = out[v][j];
+                if (outgoing.node == incoming.node) {
+                    continue;
+                }
+                // no path of at most this length avoids v, so the shortcut is required
+                int viaV = incoming.weight + outgoing.weight;
+                if (witnessDistance[outgoing.node] > viaV) {
+                    addShortcut(incoming.node, outgoing.node, viaV, v);
+                }
+            }
+        }
+    };
+
+    // Cheap shortcut estimate for the priority: a pair (u, x) only counts as witnessed if a
+    // direct edge u -> x is at most as long as the path through v. This over-estimates the
+    // shortcuts a full witness search would add, but costs O(degree) per in-neighbor
+    vector<int> directWeight(num_nodes, INF);
+    auto estimateShortcuts = [&](int v) {
+        int needed = 0;
+        for (const CHEdge &incoming : in[v]) {
+            for (const CHEdge &edge : out[incoming.node]) {
+                directWeight[edge.node] = edge.weight;
+            }
+            for (const CHEdge &outgoing : out[v]) {
+                if (outgoing.node != incoming.node && directWeight[outgoing.node] > incoming.weight + outgoing.weight) {
+                    needed++;
+                }
+            }
+            for (const CHEdge &edge : out[incoming.node]) {
+                directWeight[edge.node] = INF;
+            }
+        }
+        return needed;
+    };
+
+    // Edge difference, plus the number of already contracted neighbors to spread contraction evenly
+    vector<int> contractedNeighbors(num_nodes, 0);
+    auto priority = [&](int v) {
+        return estimateShortcuts(v) - static_cast<int>(in[v].size() + out[v].size()) + contractedNeighbors[v];
+    };
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> order;
+    for (int v = 0; v < num_nodes; v++) {
+        order.emplace(priority(v), v);
+    }
+
+    rank.assign(num_nodes, 0);
+    vector<char> contracted(num_nodes, 0);
+    vector<vector<CHEdge>> upward(num_nodes), downward(num_nodes);
+    int nextRank = 0;
+    int remainingNodes = num_nodes;
+    vector<int> neighbors;
+
+    while (!order.empty()) {
+        pair<int, int> top_node = order.top();
+        order.pop();
+        int v = top_node.second;
+        if (contracted[v]) {
+            continue;
+        }
+
+        // Lazy update: the stored priority may be outdated, re-check against the next candidate
+        int current = priority(v);
+        if (!order.empty() && current > order.top().first) {
+            order.emplace(current, v);
+            continue;
+        }
+
+        // The rest of the graph is too dense to contract profitably; keep it as the core
+        if (2.0 * remainingEdges / remainingNodes >= coreDegreeLimit) {
+            break;
+        }
+
+        contractNode(v);
+        contracted[v] = 1;
+        rank[v] = nextRank++;
+        remainingNodes--;
+
+        // Freeze v's edges: all its remaining neighbors get a higher rank than v
+        upward[v] = std::move(out[v]);
+        downward[v] = std::move(in[v]);
+        out[v].clear();
+        in[v].clear();
+        remainingEdges -= upward[v].size() + downward[v].size();
+
+        neighbors.clear();
+        for (const CHEdge &edge : upward[v]) {
+            auto &list = in[edge.node];
+            list.erase(remove_if(list.begin(), list.end(), [v](const CHEdge &e) { return e.node == v; }), list.end());
+            neighbors.push_back(edge.node);
+        }
+        for (const CHEdge &edge : downward[v]) {
+            auto &list = out[edge.node];
+            list.erase(remove_if(list.begin(), list.end(), [v](const CHEdge &e) { return e.node == v; }), list.end());
+            neighbors.push_back(edge.node);
+        }
+        sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        for (int neighbor : neighbors) {
+            contractedNeighbors[neighbor]++;
+        }
+    }
+
+    // Whatever was not contracted forms the core, ranked above every contracted node
+    core = 0;
+    for (int v = 0; v < num_nodes; v++) {
+        if (!contracted[v]) {
+            rank[v] = nextRank;
+            upward[v] = std::move(out[v]);
+            downward[v] = std::move(in[v]);
+            core++;
+        }
+    }
+
+    // Flatten both search graphs into CSR arrays
+    auto flatten = [&](vector<vector<CHEdge>> &lists, vector<int> &offsets, vector<CHEdge> &edges) {
+        offsets.assign(num_nodes + 1, 0);
+        for (int v = 0; v < num_nodes; v++) {
+            offsets[v + 1] = offsets[v] + static_cast<int>(lists[v].size());
+        }
+        edges.clear();
+        edges.reserve(offsets[num_nodes]);
+        for (auto &list : lists) {
+            for (const CHEdge &edge : list) {
+                shortcuts += edge.middle != -1;
+                edges.push_back(edge);
+            }
+            vector<CHEdge>().swap(list);
+        }
+    };
+    shortcuts = 0;
+    flatten(upward, upOffsets, upEdges);
+    flatten(downward, downOffsets, downEdges);
+
+    for (int side = 0; side < 2; side++) {
+        distance[side].assign(num_nodes, INF);
+        predecessor[side].assign(num_nodes, -1);
+    }
+}
+
+const ContractionHierarchy::CHEdge *ContractionHierarchy::findEdge(const vector<int> &offsets,
+                                                                   const vector<CHEdge> &edges,
+                                                                   int node,
+                                                                   int other)
+{
+    for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+        if (edges[i].node == other) {
+            return &edges[i];
+        }
+    }
+    return nullptr;
+}
+
+// Replace the edge from -> to by the original edges it stands for, appending everything after `from`
+void ContractionHierarchy::unpack(int from, int to, int middle, vector<int> &path) const
+{
+    if (middle == -1) {
+        path.push_back(to);
+        return;
+    }
+    // When `middle` was contracted, from -> middle was one of its incoming and middle -> to one of its outgoing edges
+    const CHEdge *first = findEdge(downOffsets, downEdges, middle, from);
+    const CHEdge *second = findEdge(upOffsets, upEdges, middle, to);
+    unpack(from, middle, first->middle, path);
+    unpack(middle, to, second->middle, path);
+}
+
+// Two phases: exhaustive upward searches through the contracted nodes, then a
+// bidirectional Dijkstra inside the core seeded with the core nodes they reached
+template<typename Stats>
+pair<vector<int>, int> ContractionHierarchy::search(const int source, const int target, Stats &stats) const
+{
+    const int INF = numeric_limits<int>::max();
+    const int coreRank = static_cast<int>(rank.size()) - core;
+    using MinHeap = priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>>;
+
+    long long best = INF;
+    int meetingNode = -1;
+    stats.onRound();
+
+    // Relax the edges of from_node on one side and record paths closed with the other side
+    auto relax = [&](int side, int from_node, MinHeap &pq) {
+        const vector<int> &offsets = side == 0 ? upOffsets : downOffsets;
+        const vector<CHEdge> &edges = side == 0 ? upEdges : downEdges;
+        for (int i = offsets[from_node]; i < offsets[from_node + 1]; i++) {
+            int to_node = edges[i].node;
+            int newDist = distance[side][from_node] + edges[i].weight;
+            stats.onRelax();
+            if (newDist < distance[side][to_node]) {
+                if (distance[0][to_node] == INF && distance[1][to_node] == INF) {
+                    touched.push_back(to_node);
+                }
+                distance[side][to_node] = newDist;
+                predecessor[side][to_node] = from_node;
+                pq.emplace(newDist, to_node);
+                stats.onImprove();
+                stats.onPush(pq.size());
+            }
+            if (distance[1 - side][to_node] != INF) {
+                long long through = static_cast<long long>(distance[side][to_node]) + distance[1 - side][to_node];
+                if (through < best) {
+                    best = through;
+                    meetingNode = to_node;
+                }
+            }
+        }
+    };
+
+    distance[0][source] = 0;
+    distance[1][target] = 0;
+    touched.push_back(source);
+    touched.push_back(target);
+    if (source == target) {
+        best = 0;
+        meetingNode = source;
+    }
+
+    // Phase 1: upward searches that stop at the core. They only climb the hierarchy, so
+    // they stay small and run to completion without a stopping rule
+    MinHeap pq[2];
+    vector<int> coreEntries[2];
+    for (int side = 0; side < 2; side++) {
+        MinHeap upward;
+        upward.emplace(0, side == 0 ? source : target);
+        stats.onPush(upward.size());
+        while (!upward.empty()) {
+            pair<int, int> top_node = upward.top();
+            upward.pop();
+            stats.onPop();
+            int from_node = top_node.second;
+            if (top_node.first > distance[side][from_node]) {
+                stats.onStale();
+                continue;
+            }
+            if (rank[from_node] >= coreRank) {
+                coreEntries[side].push_back(from_node);
+                continue;
+            }
+            stats.onSettle();
+            relax(side, from_node, upward);
+        }
+    }
+
+    // Phase 2: core nodes have only core edges left, and searching the core is plain
+    // bidirectional Dijkstra from many sources to many targets, so the usual
+    // "both keys add up to the best path" stopping rule applies
+    for (int side = 0; side < 2; side++) {
+        for (int node : coreEntries[side]) {
+            pq[side].emplace(distance[side][node], node);
+            stats.onPush(pq[side].size());
+        }
+    }
+    while (!pq[0].empty() && !pq[1].empty()) {
+        if (static_cast<long long>(pq[0].top().first) + pq[1].top().first >= best) {
+            break;
+        }
+        const int side = pq[0].top().first <= pq[1].top().first ? 0 : 1;
+        pair<int, int> top_node = pq[side].top();
+        pq[side].pop();
+        stats.onPop();
+        if (top_node.first > distance[side][top_node.second]) {
+            stats.onStale();
+            continue;
+        }
+        stats.onSettle();
+        relax(side, top_node.second, pq[side]);
+    }
+
+    vector<int> finalPath;
+    if (meetingNode != -1) {
+        // source ... meetingNode along upward edges
+        vector<int> upChain;
+        for (int at = meetingNode; at != -1; at = predecessor[0][at]) {
+            upChain.push_back(at);
+        }
+        reverse(upChain.begin(), upChain.end());
+        finalPath.push_back(source);
+        for (size_t i = 0; i + 1 < upChain.size(); i++) {
+            unpack(upChain[i], upChain[i + 1], findEdge(upOffsets, upEdges, upChain[i], upChain[i + 1])->middle, finalPath);
+        }
+
+        // meetingNode ... target; the backward predecessor of u is the next node towards the target
+        for (int at = meetingNode; predecessor[1][at] != -1; at = predecessor[1][at]) {
+            int next = predecessor[1][at];
+            unpack(at, next, findEdge(downOffsets, downEdges, next, at)->middle, finalPath);
+        }
+    }
+
+    // Reset only what this query touched
+    for (int node : touched) {
+        for (int i = 0; i < 2; i++) {
+            distance[i][node] = INF;
+            predecessor[i][node] = -1;
+        }
+    }
+    touched.clear();
+
+    if (meetingNode == -1) {
+        return {finalPath, INF};
+    }
+    return {finalPath, static_cast<int>(best)};
+}
+
+pair<vector<int>, int> ContractionHierarchy::query(const int source, const int target, SearchStats *stats) const
+{
+    if (stats) {
+        return search(source, target, *stats);
+    }
+    NoStats none;
+    return search(source, target, none);
+}
+
+size_t ContractionHierarchy::memoryBytes() const
+{
+    return (upEdges.size() + downEdges.size()) * sizeof(CHEdge)
+           + (upOffsets.size() + downOffsets.size() + rank.size()) * sizeof(int);
+}
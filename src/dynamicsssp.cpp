@@ -0,0 +1,274 @@
+#include "../include/dynamicsssp.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+static const int INF = numeric_limits<int>::max();
+
+// Index of the edge to node in edges, -1 if there is none
+static int findEdge(const vector<Edge> &edges, const int node)
+{
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (edges[i].toNode == node) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Removes the edge to node by moving the last edge into its place
+static void eraseEdge(vector<Edge> &edges, const int node)
+{
+    const int index = findEdge(edges, node);
+    edges[index] = edges.back();
+    edges.pop_back();
+}
+
+DynamicShortestPaths::DynamicShortestPaths(const CSRGraph &graph, const int source)
+    : root(source), outEdges(graph.numNodes()), inEdges(graph.numNodes())
+{
+    checkNode(source);
+    if (graph.minWeight() < 0) {
+        throw invalid_argument("dynamic shortest paths need non-negative weights");
+    }
+
+    // Keep the lightest of any parallel edges; slot[v] is the position of u -> v in outEdges[u]
+    vector<int> slot(graph.numNodes(), -1);
+    for (int u = 0; u < graph.numNodes(); u++) {
+        vector<Edge> &edges = outEdges[u];
+        for (int e = graph.edgesBegin(u); e < graph.edgesEnd(u); e++) {
+            const int v = graph.target(e);
+            if (slot[v] < 0) {
+                slot[v] = static_cast<int>(edges.size());
+                edges.push_back({v, graph.weight(e)});
+            } else {
+                edges[slot[v]].weight = min(edges[slot[v]].weight, graph.weight(e));
+            }
+        }
+        for (const Edge &edge : edges) {
+            slot[edge.toNode] = -1;
+            inEdges[edge.toNode].push_back({u, edge.weight});
+        }
+        edgeCount += edges.size();
+    }
+
+    spt = DijkstraTree(graph, source);
+    affected.assign(graph.numNodes(), 0);
+}
+
+void DynamicShortestPaths::insertEdge(const int from, const int to, const int weight, SearchStats *stats)
+{
+    checkNode(from);
+    checkNode(to);
+    if (weight < 0) {
+        throw invalid_argument("dynamic shortest paths need non-negative weights");
+    }
+    updateEdge(from, to, weight, stats);
+}
+
+bool DynamicShortestPaths::removeEdge(const int from, const int to, SearchStats *stats)
+{
+    checkNode(from);
+    checkNode(to);
+    lastAffected = 0;
+    if (findEdge(outEdges[from], to) < 0) {
+        return false;
+    }
+    eraseEdge(outEdges[from], to);
+    eraseEdge(inEdges[to], from);
+    edgeCount--;
+
+    SearchStats counters;
+    increased(from, to, counters);
+    if (stats) {
+        *stats += counters;
+    }
+    return true;
+}
+
+bool DynamicShortestPaths::setWeight(const int from, const int to, const int weight, SearchStats *stats)
+{
+    checkNode(from);
+    checkNode(to);
+    if (weight < 0) {
+        throw invalid_argument("dynamic shortest paths need non-negative weights");
+    }
+    lastAffected = 0;
+    if (findEdge(outEdges[from], to) < 0) {
+        return false;
+    }
+    updateEdge(from, to, weight, stats);
+    return true;
+}
+
+int DynamicShortestPaths::weight(const int from, const int to) const
+{
+    checkNode(from);
+    const int index = findEdge(outEdges[from], to);
+    return index < 0 ? -1 : outEdges[from][index].weight;
+}
+
+CSRGraph DynamicShortestPaths::toCSR() const
+{
+    return CSRGraph(outEdges);
+}
+
+void DynamicShortestPaths::checkNode(const int node) const
+{
+    if (node < 0 || node >= numNodes()) {
+        throw invalid_argument("node " + to_string(node) + " does not exist");
+    }
+}
+
+// Stores the new weight of from -> to (adding the edge if needed) and repairs the tree
+void DynamicShortestPaths::updateEdge(const int from, const int to, const int weight, SearchStats *stats)
+{
+    lastAffected = 0;
+    const int index = findEdge(outEdges[from], to);
+    const int oldWeight = index < 0 ? INF : outEdges[from][index].weight;
+    if (index < 0) {
+        outEdges[from].push_back({to, weight});
+        inEdges[to].push_back({from, weight});
+        edgeCount++;
+    } else {
+        outEdges[from][index].weight = weight;
+        inEdges[to][findEdge(inEdges[to], from)].weight = weight;
+    }
+
+    SearchStats counters;
+    if (weight < oldWeight) {
+        decreased(from, to, weight, counters);
+    } else if (weight > oldWeight) {
+        increased(from, to, counters);
+    }
+    if (stats) {
+        *stats += counters;
+    }
+}
+
+// A shorter edge: Dijkstra from its head, expanding only the nodes it improves
+void DynamicShortestPaths::decreased(const int from, const int to, const int weight, SearchStats &stats)
+{
+    vector<int> &distance = spt.distance;
+    vector<int> &predecessor = spt.predecessor;
+    if (distance[from] == INF || distance[from] + weight >= distance[to]) {
+        return; // the edge is not on any shortest path
+    }
+
+    const greater<> heapOrder;
+    distance[to] = distance[from] + weight;
+    predecessor[to] = from;
+    heap.clear();
+    heap.emplace_back(distance[to], to);
+    stats.onRound();
+    stats.onPush(heap.size());
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), heapOrder);
+        const auto [currentDist, node] = heap.back();
+        heap.pop_back();
+        stats.onPop();
+        if (currentDist > distance[node]) {
+            stats.onStale();
+            continue;
+        }
+        stats.onSettle();
+        lastAffected++;
+
+        for (const Edge &edge : outEdges[node]) {
+            stats.onRelax();
+            if (currentDist + edge.weight < distance[edge.toNode]) {
+                distance[edge.toNode] = currentDist + edge.weight;
+                predecessor[edge.toNode] = node;
+                stats.onImprove();
+                heap.emplace_back(distance[edge.toNode], edge.toNode);
+                push_heap(heap.begin(), heap.end(), heapOrder);
+                stats.onPush(heap.size());
+            }
+        }
+    }
+}
+
+// A longer or removed edge: if it was the tree edge into to, re-label the subtree below to
+void DynamicShortestPaths::increased(const int from, const int to, SearchStats &stats)
+{
+    vector<int> &distance = spt.distance;
+    vector<int> &predecessor = spt.predecessor;
+    if (predecessor[to] != from) {
+        return; // every tree path avoids the edge, so no distance changes
+    }
+
+    // Only nodes whose tree path runs through the edge can get longer distances
+    subtree.assign(1, to);
+    affected[to] = 1;
+    for (size_t i = 0; i < subtree.size(); i++) {
+        for (const Edge &edge : outEdges[subtree[i]]) {
+            if (predecessor[edge.toNode] == subtree[i] && !affected[edge.toNode]) {
+                affected[edge.toNode] = 1;
+                subtree.push_back(edge.toNode);
+            }
+        }
+    }
+    lastAffected = static_cast<int>(subtree.size());
+    for (const int node : subtree) {
+        distance[node] = INF;
+        predecessor[node] = -1;
+    }
+
+    // Seed every affected node with its best in-edge from the rest of the tree, whose distances stay valid
+    const greater<> heapOrder;
+    heap.clear();
+    stats.onRound();
+    for (const int node : subtree) {
+        for (const Edge &edge : inEdges[node]) {
+            if (affected[edge.toNode] || distance[edge.toNode] == INF) {
+                continue;
+            }
+            stats.onRelax();
+            if (distance[edge.toNode] + edge.weight < distance[node]) {
+                distance[node] = distance[edge.toNode] + edge.weight;
+                predecessor[node] = edge.toNode;
+                stats.onImprove();
+            }
+        }
+        if (distance[node] != INF) {
+            heap.emplace_back(distance[node], node);
+            stats.onPush(heap.size());
+        }
+    }
+    make_heap(heap.begin(), heap.end(), heapOrder);
+
+    // Dijkstra within the subtree settles the remaining affected nodes
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), heapOrder);
+        const auto [currentDist, node] = heap.back();
+        heap.pop_back();
+        stats.onPop();
+        if (currentDist > distance[node]) {
+            stats.onStale();
+            continue;
+        }
+        stats.onSettle();
+
+        for (const Edge &edge : outEdges[node]) {
+            if (!affected[edge.toNode]) {
+                continue;
+            }
+            stats.onRelax();
+            if (currentDist + edge.weight < distance[edge.toNode]) {
+                distance[edge.toNode] = currentDist + edge.weight;
+                predecessor[edge.toNode] = node;
+                stats.onImprove();
+                heap.emplace_back(distance[edge.toNode], edge.toNode);
+                push_heap(heap.begin(), heap.end(), heapOrder);
+                stats.onPush(heap.size());
+            }
+        }
+    }
+
+    for (const int node : subtree) {
+        affected[node] = 0;
+    }
+}
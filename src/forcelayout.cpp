@@ -0,0 +1,196 @@
+#include "../include/forcelayout.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+using namespace std;
+
+// Nodes per chunk of the parallel force loop
+static const int LAYOUT_GRAIN = 256;
+
+// Cells are not split below this depth; deeper bodies share a leaf (they are practically coincident)
+static const int MAX_TREE_DEPTH = 40;
+
+ForceLayout::ForceLayout(const CSRGraph &graph, ThreadPool &pool, const LayoutOptions &options)
+    : pool(pool), options(options), neighbours(graph.undirected())
+{
+    const int n = graph.numNodes();
+
+    // A disc whose area gives every node about edgeLength^2, uniformly filled
+    const double radius = options.edgeLength * sqrt(static_cast<double>(max(n, 1)));
+    mt19937_64 random(options.seed);
+    uniform_real_distribution<double> unit(0, 1);
+    points.resize(n);
+    for (LayoutPoint &point : points) {
+        const double r = radius * sqrt(unit(random));
+        const double angle = 2 * M_PI * unit(random);
+        point = {r * cos(angle), r * sin(angle)};
+    }
+    next.resize(n);
+    sharing.resize(n);
+    heat = radius / 10;
+}
+
+int ForceLayout::run(const int count)
+{
+    const int n = static_cast<int>(points.size());
+    int done = 0;
+    for (; done < count && !converged(); done++) {
+        buildTree();
+
+        // Every node moves along its force by at most the temperature, computed from the old positions
+        pool.parallelFor(n, LAYOUT_GRAIN, [&](int begin, int end, int) {
+            for (int i = begin; i < end; i++) {
+                const int v = order[i];
+                const LayoutPoint push = force(v);
+                const double length = hypot(push.x, push.y);
+                const double step = length > heat ? heat / length : 1;
+                next[v] = {points[v].x + push.x * step, points[v].y + push.y * step};
+            }
+        });
+        points.swap(next);
+        heat *= options.cooling;
+        iterations++;
+    }
+    return done;
+}
+
+bool ForceLayout::converged() const
+{
+    return heat < options.edgeLength * options.minStep || iterations >= options.maxIterations || points.size() < 2;
+}
+
+// Rebuilds the quadtree over the current positions and turns the mass sums into centres of mass
+void ForceLayout::buildTree()
+{
+    double minX = points[0].x, maxX = minX, minY = points[0].y, maxY = minY;
+    for (const LayoutPoint &point : points) {
+        minX = min(minX, point.x);
+        maxX = max(maxX, point.x);
+        minY = min(minY, point.y);
+        maxY = max(maxY, point.y);
+    }
+
+    cells.clear();
+    Cell root;
+    root.x = minX;
+    root.y = minY;
+    root.size = max({maxX - minX, maxY - minY, 1e-9}) * 1.0001; // the largest coordinates stay inside
+    cells.push_back(root);
+    for (int v = 0; v < static_cast<int>(points.size()); v++) {
+        insert(v);
+    }
+    for (Cell &cell : cells) {
+        cell.massX /= cell.mass;
+        cell.massY /= cell.mass;
+    }
+
+    // Nodes in tree order: neighbouring nodes in a chunk walk mostly the same cells
+    order.clear();
+    vector<int> stack{0};
+    while (!stack.empty()) {
+        const Cell &cell = cells[stack.back()];
+        stack.pop_back();
+        for (int body = cell.body; body >= 0; body = sharing[body]) {
+            order.push_back(body);
+        }
+        for (int child : cell.children) {
+            if (child >= 0) {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+// Adds a node to every cell on its way down and leaves it in the first empty leaf, or in the shared one at the depth limit
+void ForceLayout::insert(const int node)
+{
+    const LayoutPoint &point = points[node];
+    int cell = 0;
+    for (int depth = 0;; depth++) {
+        cells[cell].mass++;
+        cells[cell].massX += point.x;
+        cells[cell].massY += point.y;
+        if (cells[cell].mass == 1) {
+            cells[cell].body = node; // an empty leaf until now
+            sharing[node] = -1;
+            return;
+        }
+        if (depth == MAX_TREE_DEPTH) {
+            sharing[node] = cells[cell].body;
+            cells[cell].body = node;
+            return;
+        }
+
+        // An occupied leaf becomes internal: its body moves down into a child first
+        const int resident = cells[cell].body;
+        cells[cell].body = -1;
+        for (int moving : {resident, node}) {
+            if (moving < 0) {
+                continue;
+            }
+            const double half = cells[cell].size / 2;
+            const int quadrant = (points[moving].x >= cells[cell].x + half ? 1 : 0)
+                                 + (points[moving].y >= cells[cell].y + half ? 2 : 0);
+            if (cells[cell].children[quadrant] < 0) {
+                Cell child;
+                child.x = cells[cell].x + (quadrant & 1 ? half : 0);
+                child.y = cells[cell].y + (quadrant & 2 ? half : 0);
+                child.size = half;
+                cells[cell].children[quadrant] = static_cast<int>(cells.size());
+                cells.push_back(child); // may move cells, so cells[cell] is looked up again
+            }
+            if (moving == resident) {
+                Cell &child = cells[cells[cell].children[quadrant]];
+                child.mass = 1;
+                child.massX = points[resident].x;
+                child.massY = points[resident].y;
+                child.body = resident; // alone, as only leaves at the depth limit are shared
+            } else {
+                cell = cells[cell].children[quadrant];
+            }
+        }
+    }
+}
+
+// Barnes-Hut repulsion, edge attraction and gravity on one node
+LayoutPoint ForceLayout::force(const int node) const
+{
+    const double k = options.edgeLength;
+    const double k2 = k * k;
+    const double theta2 = options.theta * options.theta;
+    const LayoutPoint &point = points[node];
+    LayoutPoint total{-options.gravity * point.x, -options.gravity * point.y};
+
+    int stack[4 * MAX_TREE_DEPTH + 4];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Cell &cell = cells[stack[--top]];
+        const double dx = point.x - cell.massX;
+        const double dy = point.y - cell.massY;
+        const double distance2 = dx * dx + dy * dy;
+        const bool leaf = cell.children[0] < 0 && cell.children[1] < 0 && cell.children[2] < 0 && cell.children[3] < 0;
+        if (leaf || cell.size * cell.size < theta2 * distance2) {
+            if (distance2 > 0) { // skips the node itself (and bodies exactly on top of it)
+                total.x += k2 * cell.mass * dx / distance2;
+                total.y += k2 * cell.mass * dy / distance2;
+            }
+            continue;
+        }
+        for (int child : cell.children) {
+            if (child >= 0) {
+                stack[top++] = child;
+            }
+        }
+    }
+
+    for (int e = neighbours.edgesBegin(node); e < neighbours.edgesEnd(node); e++) {
+        const LayoutPoint &other = points[neighbours.target(e)];
+        const double dx = point.x - other.x;
+        const double dy = point.y - other.y;
+        const double distance = hypot(dx, dy);
+        total.x -= dx * distance / k;
+        total.y -= dy * distance / k;
+    }
+    return total;
+}
@@ -0,0 +1,184 @@
+#include "../include/graph.h"
+#include <algorithm>
+using namespace std;
+
+// The storage of a graph built in memory
+struct VectorStorage {
+    vector<int> offsets;
+    vector<int> targets;
+    vector<int> weights;
+};
+
+// Flatten an adjacency list into offsets/targets/weights
+static VectorStorage flatten(const vector<vector<Edge>> &adjacencyList)
+{
+    VectorStorage arrays;
+    const int num_nodes = adjacencyList.size();
+    arrays.offsets.assign(num_nodes + 1, 0);
+    for (int i = 0; i < num_nodes; i++) {
+        arrays.offsets[i + 1] = arrays.offsets[i] + static_cast<int>(adjacencyList[i].size());
+    }
+
+    arrays.targets.reserve(arrays.offsets[num_nodes]);
+    arrays.weights.reserve(arrays.offsets[num_nodes]);
+    for (const auto &edges : adjacencyList) {
+        for (const Edge &edge : edges) {
+            arrays.targets.push_back(edge.toNode);
+            arrays.weights.push_back(edge.weight);
+        }
+    }
+    return arrays;
+}
+
+CSRGraph::CSRGraph(const vector<vector<Edge>> &adjacencyList)
+{
+    VectorStorage arrays = flatten(adjacencyList);
+    *this = CSRGraph(std::move(arrays.offsets), std::move(arrays.targets), std::move(arrays.weights));
+}
+
+CSRGraph::CSRGraph(vector<int> offsets, vector<int> targets, vector<int> weights, bool topologicallyOrdered)
+    : topological(topologicallyOrdered)
+{
+    auto arrays = make_shared<VectorStorage>();
+    arrays->offsets = std::move(offsets);
+    arrays->targets = std::move(targets);
+    arrays->weights = std::move(weights);
+
+    nodeCount = arrays->offsets.empty() ? 0 : static_cast<int>(arrays->offsets.size()) - 1;
+    edgeCount = arrays->targets.size();
+    this->offsets = arrays->offsets.data();
+    this->targets = arrays->targets.data();
+    this->weights = arrays->weights.data();
+    storage = std::move(arrays);
+    computeWeightRange();
+}
+
+CSRGraph CSRGraph::view(shared_ptr<const void> owner,
+                        const int num_nodes,
+                        const int num_edges,
+                        const int *offsets,
+                        const int *targets,
+                        const int *weights,
+                        const int minWeight,
+                        const int maxWeight,
+                        const bool topologicallyOrdered)
+{
+    CSRGraph graph;
+    graph.storage = std::move(owner);
+    graph.nodeCount = num_nodes;
+    graph.edgeCount = num_edges;
+    graph.offsets = offsets;
+    graph.targets = targets;
+    graph.weights = weights;
+    graph.minEdgeWeight = minWeight;
+    graph.maxEdgeWeight = maxWeight;
+    graph.topological = topologicallyOrdered;
+    return graph;
+}
+
+// Counting sort of the edges by source node (stable within each node)
+CSRGraph CSRGraph::fromEdgeList(const int num_nodes, const vector<pair<int, Edge>> &edges, bool topologicallyOrdered)
+{
+    vector<int> offsets(num_nodes + 1, 0);
+    for (const auto &edge : edges) {
+        offsets[edge.first + 1]++;
+    }
+    for (int i = 0; i < num_nodes; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    vector<int> targets(edges.size());
+    vector<int> weights(edges.size());
+    vector<int> cursor(offsets.begin(), offsets.end() - 1); // next free slot of every node
+    for (const auto &edge : edges) {
+        int slot = cursor[edge.first]++;
+        targets[slot] = edge.second.toNode;
+        weights[slot] = edge.second.weight;
+    }
+
+    return CSRGraph(std::move(offsets), std::move(targets), std::move(weights), topologicallyOrdered);
+}
+
+vector<vector<Edge>> CSRGraph::toAdjacencyList() const
+{
+    vector<vector<Edge>> adjacencyList(numNodes());
+    for (int i = 0; i < numNodes(); i++) {
+        adjacencyList[i].reserve(degree(i));
+        forEachEdge(i, [&](int toNode, int weight) {
+            adjacencyList[i].push_back({toNode, weight});
+        });
+    }
+    return adjacencyList;
+}
+
+// Counting sort of the edges by target node
+CSRGraph CSRGraph::reversed() const
+{
+    const int num_nodes = numNodes();
+    vector<int> reverseOffsets(num_nodes + 1, 0);
+    for (int i = 0; i < edgeCount; i++) {
+        reverseOffsets[targets[i] + 1]++;
+    }
+    for (int i = 0; i < num_nodes; i++) {
+        reverseOffsets[i + 1] += reverseOffsets[i];
+    }
+
+    vector<int> reverseTargets(edgeCount);
+    vector<int> reverseWeights(edgeCount);
+    vector<int> cursor(reverseOffsets.begin(), reverseOffsets.end() - 1); // next free slot of every node
+    for (int from = 0; from < num_nodes; from++) {
+        forEachEdge(from, [&](int toNode, int weight) {
+            int slot = cursor[toNode]++;
+            reverseTargets[slot] = from;
+            reverseWeights[slot] = weight;
+        });
+    }
+
+    return CSRGraph(std::move(reverseOffsets), std::move(reverseTargets), std::move(reverseWeights));
+}
+
+CSRGraph CSRGraph::undirected() const
+{
+    const int num_nodes = numNodes();
+    vector<int> undirectedOffsets(num_nodes + 1, 0);
+    for (int from = 0; from < num_nodes; from++) {
+        forEachEdge(from, [&](int toNode, int) {
+            if (toNode != from) {
+                undirectedOffsets[from + 1]++;
+                undirectedOffsets[toNode + 1]++;
+            }
+        });
+    }
+    for (int i = 0; i < num_nodes; i++) {
+        undirectedOffsets[i + 1] += undirectedOffsets[i];
+    }
+
+    vector<int> undirectedTargets(undirectedOffsets[num_nodes]);
+    vector<int> undirectedWeights(undirectedOffsets[num_nodes]);
+    vector<int> cursor(undirectedOffsets.begin(), undirectedOffsets.end() - 1); // next free slot of every node
+    for (int from = 0; from < num_nodes; from++) {
+        forEachEdge(from, [&](int toNode, int weight) {
+            if (toNode != from) {
+                int slot = cursor[from]++;
+                undirectedTargets[slot] = toNode;
+                undirectedWeights[slot] = weight;
+                slot = cursor[toNode]++;
+                undirectedTargets[slot] = from;
+                undirectedWeights[slot] = weight;
+            }
+        });
+    }
+
+    return CSRGraph(std::move(undirectedOffsets), std::move(undirectedTargets), std::move(undirectedWeights));
+}
+
+void CSRGraph::computeWeightRange()
+{
+    if (edgeCount == 0) {
+        minEdgeWeight = maxEdgeWeight = 0;
+        return;
+    }
+    auto range = minmax_element(weights, weights + edgeCount);
+    minEdgeWeight = *range.first;
+    maxEdgeWeight = *range.second;
+}
@@ -0,0 +1,137 @@
+#include "../include/graphfile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include "../include/mappedfile.h"
+using namespace std;
+
+static const char GRAPH_FILE_MAGIC[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Bytes an array of count ints occupies in the file, padded so the next array is 64-byte aligned
+static size_t paddedSize(const long long count)
+{
+    return static_cast<size_t>((count * static_cast<long long>(sizeof(int32_t)) + 63) / 64 * 64);
+}
+
+// Header, then each array followed by zero padding up to the next 64-byte boundary
+void saveGraph(const string &path, const CSRGraph &graph, const bool includeReverse)
+{
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) {
+        throw runtime_error("cannot create graph file " + path);
+    }
+
+    GraphFileHeader header = {};
+    memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.version = GRAPH_FILE_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.flags = (graph.isTopologicallyOrdered() ? GRAPH_FILE_TOPOLOGICAL : 0)
+                   | (includeReverse ? GRAPH_FILE_REVERSE : 0);
+    header.numNodes = graph.numNodes();
+    header.numEdges = graph.numEdges();
+    header.minWeight = graph.minWeight();
+    header.maxWeight = graph.maxWeight();
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    static const char zeros[64] = {};
+    auto writeArray = [&](const int *values, long long count) {
+        if (count > 0) {
+            out.write(reinterpret_cast<const char *>(values), count * sizeof(int32_t));
+        }
+        out.write(zeros, paddedSize(count) - count * sizeof(int32_t));
+    };
+    auto writeGraph = [&](const CSRGraph &g) {
+        const int zeroOffset = 0;
+        writeArray(g.numNodes() > 0 ? g.offsetsData() : &zeroOffset, g.numNodes() + 1);
+        writeArray(g.targetsData(), g.numEdges());
+        writeArray(g.weightsData(), g.numEdges());
+    };
+
+    writeGraph(graph);
+    if (includeReverse) {
+        writeGraph(graph.reversed());
+    }
+
+    out.flush();
+    if (!out) {
+        throw runtime_error("cannot write graph file " + path);
+    }
+}
+
+CSRGraph loadGraph(const string &path, CSRGraph *reverseGraph)
+{
+    auto file = make_shared<MappedFile>(path);
+
+    GraphFileHeader header;
+    if (file->size() < sizeof(header)) {
+        throw runtime_error(path + " is not a graph file");
+    }
+    memcpy(&header, file->data(), sizeof(header));
+    if (memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        throw runtime_error(path + " is not a graph file");
+    }
+    if (header.version != GRAPH_FILE_VERSION) {
+        throw runtime_error(path + " has unsupported graph file version " + to_string(header.version));
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw runtime_error(path + " was written on a machine with a different byte order");
+    }
+    if (header.numNodes < 0 || header.numEdges < 0) {
+        throw runtime_error(path + " has a corrupt header");
+    }
+
+    const int num_nodes = header.numNodes;
+    const int num_edges = header.numEdges;
+    const bool hasReverse = header.flags & GRAPH_FILE_REVERSE;
+    const size_t graphBytes = paddedSize(num_nodes + 1LL) + 2 * paddedSize(num_edges);
+    if (file->size() < sizeof(header) + graphBytes * (hasReverse ? 2 : 1)) {
+        throw runtime_error(path + " is truncated");
+    }
+
+    // Point views at the arrays in place; the shared MappedFile keeps them mapped
+    auto mapGraph = [&](size_t position, bool topological) {
+        const char *base = file->data();
+        const int *offsets = reinterpret_cast<const int *>(base + position);
+        position += paddedSize(num_nodes + 1LL);
+        const int *targets = reinterpret_cast<const int *>(base + position);
+        position += paddedSize(num_edges);
+        const int *weights = reinterpret_cast<const int *>(base + position);
+
+        // One pass over the arrays, so a corrupt file fails here rather than in a search
+        if (offsets[0] != 0 || offsets[num_nodes] != num_edges) {
+            throw runtime_error(path + " has corrupt offsets");
+        }
+        int minWeight = num_edges > 0 ? weights[0] : 0;
+        int maxWeight = minWeight;
+        for (int from = 0; from < num_nodes; from++) {
+            if (offsets[from + 1] < offsets[from] || offsets[from + 1] > num_edges) {
+                throw runtime_error(path + " has corrupt offsets");
+            }
+            for (int e = offsets[from]; e < offsets[from + 1]; e++) {
+                if (targets[e] < 0 || targets[e] >= num_nodes) {
+                    throw runtime_error(path + " has an edge to node " + to_string(targets[e]) + " out of range");
+                }
+                if (topological && targets[e] <= from) {
+                    throw runtime_error(path + " is marked topologically ordered but has an edge from "
+                                        + to_string(from) + " to " + to_string(targets[e]));
+                }
+                minWeight = min(minWeight, weights[e]);
+                maxWeight = max(maxWeight, weights[e]);
+            }
+        }
+        if (minWeight != header.minWeight || maxWeight != header.maxWeight) {
+            throw runtime_error(path + " has a weight range that does not match its header");
+        }
+        return CSRGraph::view(file, num_nodes, num_edges, offsets, targets, weights,
+                              header.minWeight, header.maxWeight, topological);
+    };
+
+    CSRGraph graph = mapGraph(sizeof(header), header.flags & GRAPH_FILE_TOPOLOGICAL);
+    if (reverseGraph) {
+        *reverseGraph = hasReverse ? mapGraph(sizeof(header) + graphBytes, false) : graph.reversed();
+    }
+    return graph;
+}
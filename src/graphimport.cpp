@@ -0,0 +1,374 @@
+#include "../include/graphimport.h"
+#include "../include/graphfile.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+using namespace std;
+
+// Bytes of text read and parsed at a time
+static const size_t CHUNK_BYTES = 16 << 20;
+
+// Pieces a chunk is split into per thread, so uneven lines still balance
+static const int PIECES_PER_THREAD = 4;
+
+// Nodes per chunk when sorting the edges of every node
+static const int SORT_GRAIN = 4096;
+
+// The longest excerpt of a malformed line quoted in an error
+static const size_t MAX_QUOTED_LINE = 80;
+
+// Totals of one pass over the arcs of a file
+struct ArcScan {
+    long long arcs = 0;
+    long long maxNode = -1;
+};
+
+// The outcome of parsing one line
+enum class LineKind {
+    Blank, // empty or a comment
+    Arc,
+    Malformed
+};
+
+static inline void skipBlanks(const char *&p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+}
+
+// Parses a decimal integer at p; false if there is none, it is followed by a non-blank or it does not fit an int
+static inline bool parseInt(const char *&p, const char *end, long long &value)
+{
+    skipBlanks(p, end);
+    const bool negative = p < end && *p == '-';
+    if (negative || (p < end && *p == '+')) {
+        p++;
+    }
+
+    const char *digits = p;
+    long long result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        if (result > INT_MAX + 1LL) {
+            return false;
+        }
+        p++;
+    }
+    if (p == digits || (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')) {
+        return false;
+    }
+
+    value = negative ? -result : result;
+    return value >= INT_MIN && value <= INT_MAX;
+}
+
+// Parses the line at p into arc (from, to, weight as written) and moves p past it
+static LineKind parseLine(const char *&p, const char *end, const bool dimacs, long long arc[3])
+{
+    LineKind kind = LineKind::Blank;
+    skipBlanks(p, end);
+    if (p < end && *p != '\n') {
+        const char first = *p;
+        if (dimacs ? (first == 'c' || first == 'p') : (first == '#' || first == '%')) {
+            kind = LineKind::Blank;
+        } else if (dimacs && first != 'a') {
+            kind = LineKind::Malformed;
+        } else {
+            if (dimacs) {
+                p++;
+            }
+            kind = LineKind::Malformed;
+            if (parseInt(p, end, arc[0]) && parseInt(p, end, arc[1])) {
+                arc[2] = 1;
+                skipBlanks(p, end);
+                const bool hasWeight = p < end && *p != '\n';
+                if ((!hasWeight && !dimacs) || (hasWeight && parseInt(p, end, arc[2]))) {
+                    skipBlanks(p, end);
+                    if (p == end || *p == '\n') {
+                        kind = LineKind::Arc;
+                    }
+                }
+            }
+        }
+    }
+
+    const char *newline = static_cast<const char *>(memchr(p, '\n', end - p));
+    p = newline ? newline + 1 : end;
+    return kind;
+}
+
+// The line starting at line, cut short for an error message
+static string quoteLine(const char *line, const char *end)
+{
+    const char *newline = static_cast<const char *>(memchr(line, '\n', end - line));
+    size_t length = (newline ? newline : end) - line;
+    while (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+    return "\"" + string(line, min(length, MAX_QUOTED_LINE)) + (length > MAX_QUOTED_LINE ? "...\"" : "\"");
+}
+
+// Reads a file in chunks that end on a line boundary and calls process(begin, end) on each
+template<typename Process>
+static void forEachChunk(const string &path, Process &&process)
+{
+    ifstream in(path, ios::binary);
+    if (!in) {
+        throw runtime_error("cannot open graph file " + path);
+    }
+
+    vector<char> buffer(CHUNK_BYTES);
+    size_t carried = 0; // bytes of an unfinished line left at the front of the buffer
+    while (true) {
+        in.read(buffer.data() + carried, buffer.size() - carried);
+        const size_t filled = carried + in.gcount();
+        const bool last = !in;
+        if (filled == 0) {
+            break;
+        }
+
+        size_t end = filled;
+        if (!last) {
+            while (end > 0 && buffer[end - 1] != '\n') {
+                end--;
+            }
+            if (end == 0) {
+                // A single line longer than the buffer
+                carried = filled;
+                buffer.resize(buffer.size() * 2);
+                continue;
+            }
+        }
+
+        process(buffer.data(), buffer.data() + end);
+        if (last) {
+            break;
+        }
+        carried = filled - end;
+        memmove(buffer.data(), buffer.data() + end, carried);
+    }
+}
+
+// Parses every arc of a text file in parallel and calls onArc(from, to, weight) with 0-based ids.
+// num_nodes bounds the ids if it is known (DIMACS), -1 otherwise.
+template<typename OnArc>
+static ArcScan forEachArc(const string &path, const bool dimacs, const long long num_nodes, ThreadPool &pool, OnArc &&onArc)
+{
+    const int pieces = pool.size() * PIECES_PER_THREAD;
+    vector<ArcScan> scans(pool.size());
+    vector<string> errors(pool.size());
+
+    forEachChunk(path, [&](const char *begin, const char *end) {
+        // Piece boundaries, each moved forward to the start of a line
+        vector<const char *> bounds(pieces + 1, end);
+        bounds[0] = begin;
+        for (int k = 1; k < pieces; k++) {
+            const char *p = max(bounds[k - 1], begin + (end - begin) / pieces * k);
+            if (p > begin && p < end && p[-1] != '\n') {
+                const char *newline = static_cast<const char *>(memchr(p, '\n', end - p));
+                p = newline ? newline + 1 : end;
+            }
+            bounds[k] = p;
+        }
+
+        pool.parallelFor(pieces, 1, [&](int first, int last, int worker) {
+            ArcScan scan;
+            for (int piece = first; piece < last && errors[worker].empty(); piece++) {
+                const char *p = bounds[piece];
+                const char *pieceEnd = bounds[piece + 1];
+                while (p < pieceEnd) {
+                    const char *line = p;
+                    long long arc[3] = {0, 0, 0};
+                    const LineKind kind = parseLine(p, pieceEnd, dimacs, arc);
+                    if (kind == LineKind::Blank) {
+                        continue;
+                    }
+
+                    // DIMACS ids are 1-based; every id must leave room for the node count in an int
+                    const long long from = dimacs ? arc[0] - 1 : arc[0];
+                    const long long to = dimacs ? arc[1] - 1 : arc[1];
+                    const long long limit = num_nodes >= 0 ? num_nodes : INT_MAX - 1LL;
+                    if (kind == LineKind::Malformed) {
+                        errors[worker] = "malformed line " + quoteLine(line, pieceEnd);
+                        break;
+                    }
+                    if (from < 0 || to < 0 || from >= limit || to >= limit) {
+                        errors[worker] = "node id out of range in line " + quoteLine(line, pieceEnd);
+                        break;
+                    }
+
+                    onArc(static_cast<int>(from), static_cast<int>(to), static_cast<int>(arc[2]));
+                    scan.arcs++;
+                    scan.maxNode = max(scan.maxNode, max(from, to));
+                }
+            }
+            scans[worker].arcs += scan.arcs;
+            scans[worker].maxNode = max(scans[worker].maxNode, scan.maxNode);
+        });
+
+        for (const string &error : errors) {
+            if (!error.empty()) {
+                throw runtime_error(path + ": " + error);
+            }
+        }
+    });
+
+    ArcScan total;
+    for (const ArcScan &scan : scans) {
+        total.arcs += scan.arcs;
+        total.maxNode = max(total.maxNode, scan.maxNode);
+    }
+    return total;
+}
+
+// Reads the "p sp <nodes> <arcs>" line that precedes the arcs of a DIMACS file
+static void readProblemLine(const string &path, long long &num_nodes, long long &num_edges)
+{
+    ifstream in(path, ios::binary);
+    if (!in) {
+        throw runtime_error("cannot open graph file " + path);
+    }
+
+    string line;
+    while (getline(in, line)) {
+        const char *p = line.data();
+        const char *end = p + line.size();
+        skipBlanks(p, end);
+        if (p == end || *p == 'c') {
+            continue;
+        }
+        if (*p == 'p') {
+            p++;
+            skipBlanks(p, end);
+            const bool shortestPath = end - p > 2 && p[0] == 's' && p[1] == 'p' && (p[2] == ' ' || p[2] == '\t');
+            if (shortestPath) {
+                p += 2;
+                if (parseInt(p, end, num_nodes) && parseInt(p, end, num_edges) && num_nodes >= 0 && num_edges >= 0) {
+                    return;
+                }
+            }
+        }
+        break;
+    }
+    throw runtime_error(path + ": missing \"p sp <nodes> <arcs>\" line before the arcs");
+}
+
+// Guesses the format of a file from its first bytes and its extension
+static GraphFormat detectFormat(const string &path)
+{
+    ifstream in(path, ios::binary);
+    if (!in) {
+        throw runtime_error("cannot open graph file " + path);
+    }
+
+    char start[4096];
+    in.read(start, sizeof(start));
+    const size_t length = in.gcount();
+    if (length >= 8 && memcmp(start, "CSRGRAPH", 8) == 0) {
+        return GraphFormat::Binary;
+    }
+    if (path.size() >= 3 && path.compare(path.size() - 3, 3, ".gr") == 0) {
+        return GraphFormat::Dimacs;
+    }
+
+    // The first non-blank line decides: DIMACS files open with comments or the problem line
+    const char *p = start;
+    const char *end = start + length;
+    while (p < end) {
+        skipBlanks(p, end);
+        if (p < end && *p != '\n') {
+            return (*p == 'c' || *p == 'p') ? GraphFormat::Dimacs : GraphFormat::EdgeList;
+        }
+        p++;
+    }
+    return GraphFormat::EdgeList;
+}
+
+CSRGraph importGraph(const string &path, GraphFormat format, ThreadPool &pool)
+{
+    if (format == GraphFormat::Auto) {
+        format = detectFormat(path);
+    }
+    if (format == GraphFormat::Binary) {
+        return loadGraph(path);
+    }
+
+    const bool dimacs = format == GraphFormat::Dimacs;
+    long long num_nodes = -1;
+    long long num_edges = -1;
+    if (dimacs) {
+        readProblemLine(path, num_nodes, num_edges);
+    } else {
+        const ArcScan scan = forEachArc(path, false, -1, pool, [](int, int, int) {});
+        num_nodes = scan.maxNode + 1;
+        num_edges = scan.arcs;
+    }
+    if (num_nodes > INT_MAX - 1LL || num_edges > INT_MAX) {
+        throw runtime_error(path + ": the graph is too large for 32-bit node and edge ids");
+    }
+
+    // Pass 1: out-degrees
+    vector<atomic<int>> cursor(num_nodes);
+    const ArcScan counted = forEachArc(path, dimacs, num_nodes, pool, [&](int from, int, int) {
+        cursor[from].fetch_add(1, memory_order_relaxed);
+    });
+    if (counted.arcs != num_edges) {
+        throw runtime_error(path + ": declares " + to_string(num_edges) + " arcs but contains " + to_string(counted.arcs));
+    }
+
+    vector<int> offsets(num_nodes + 1, 0);
+    for (int u = 0; u < num_nodes; u++) {
+        offsets[u + 1] = offsets[u] + cursor[u].load(memory_order_relaxed);
+        cursor[u].store(offsets[u], memory_order_relaxed);
+    }
+
+    // Pass 2: every arc claims the next free slot of its source node
+    vector<int> targets(num_edges);
+    vector<int> weights(num_edges);
+    atomic<bool> overflow{false};
+    const ArcScan filled = forEachArc(path, dimacs, num_nodes, pool, [&](int from, int to, int weight) {
+        const int slot = cursor[from].fetch_add(1, memory_order_relaxed);
+        if (slot >= offsets[from + 1]) {
+            overflow.store(true, memory_order_relaxed);
+            return;
+        }
+        targets[slot] = to;
+        weights[slot] = weight;
+    });
+    if (overflow.load() || filled.arcs != counted.arcs) {
+        throw runtime_error(path + ": the file changed while it was being read");
+    }
+    vector<atomic<int>>().swap(cursor);
+
+    // The slot order depends on thread timing; sorting each node's edges makes the result deterministic
+    vector<vector<pair<int, int>>> scratch(pool.size());
+    pool.parallelFor(static_cast<int>(num_nodes), SORT_GRAIN, [&](int first, int last, int worker) {
+        vector<pair<int, int>> &edges = scratch[worker];
+        for (int u = first; u < last; u++) {
+            if (offsets[u + 1] - offsets[u] < 2) {
+                continue;
+            }
+            edges.clear();
+            for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+                edges.push_back({targets[i], weights[i]});
+            }
+            sort(edges.begin(), edges.end());
+            for (int i = offsets[u]; i < offsets[u + 1]; i++) {
+                targets[i] = edges[i - offsets[u]].first;
+                weights[i] = edges[i - offsets[u]].second;
+            }
+        }
+    });
+
+    return CSRGraph(std::move(offsets), std::move(targets), std::move(weights));
+}
+
+CSRGraph importGraph(const string &path, const GraphFormat format, const int num_threads)
+{
+    ThreadPool pool(num_threads);
+    return importGraph(path, format, pool);
+}
@@ -1,19 +1,32 @@
 #include "../include/graphwidget.h"
 #include "../include/constants.h"
+#include "../include/forcelayout.h"
+#include <QElapsedTimer>
+#include <QMouseEvent>
 #include <QPainter>
+#include <QTimer>
+#include <QWheelEvent>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
 #include <cmath>
 using namespace std;
 
-// Function to draw a directional arrow between two points
-void drawArrow(QPainter &painter, QPointF from, QPointF to, double size = 10.0, double offset = 15.0) {
+// Key of the edge from -> to in edgeAt
+static long long edgeKey(int from, int to)
+{
+    return (static_cast<long long>(from) << 32) | static_cast<unsigned int>(to);
+}
+
+// Function to build a directional arrowhead at the end of a line
+static QPolygonF arrowHead(QPointF from, QPointF to, double size = Const::ARROW_SIZE, double offset = Const::ARROW_OFFSET) {
     QLineF line(from, to);
     double length = line.length();
-    if (length == 0) return; // Avoid division by zero
+    if (length == 0) return QPolygonF(); // Avoid division by zero
 
     // Shorten the arrow slightly so it doesn't overlap with the circle
     QPointF adjustedTo = from + (to - from) * ((length - offset) / length);
 
-    // Calculate the arrow slightly so it doesn't overlap with the circle
+    // Calculate the angle of the line
     double angle = atan2(-line.dy(), line.dx());
 
     // Calculate the two points that form the sides of the arrowhead
@@ -21,143 +34,380 @@ void drawArrow(QPainter &painter, QPointF from, QPointF to, double size = 10.0,
     QPointF arrowP2 = adjustedTo - QPointF(cos(angle - M_PI / 6) * size, -sin(angle - M_PI / 6) * size);
 
     // Create the arrowhead triangle
-    QPolygonF arrowHead;
-    arrowHead << adjustedTo << arrowP1 << arrowP2;
+    QPolygonF arrow;
+    arrow << adjustedTo << arrowP1 << arrowP2;
+    return arrow;
+}
 
-    // Draw the arrowhead in black
-    painter.setBrush(Qt::black);
-    painter.drawPolygon(arrowHead);
+// Whether the bounding box of a line overlaps a rectangle; lines along an axis have empty boxes, so QRectF::intersects does not do
+static bool overlaps(const QLineF &line, const QRectF &area)
+{
+    return max(line.x1(), line.x2()) >= area.left() && min(line.x1(), line.x2()) <= area.right()
+           && max(line.y1(), line.y2()) >= area.top() && min(line.y1(), line.y2()) <= area.bottom();
 }
 
 // Constructor: initialize custom widght for graph visualization
 GraphWidget::GraphWidget(QWidget *parent)
     : QWidget{parent}
-{}
+    , labelFont(Const::FONT_FAMILY(), Const::FONT_SIZE)
+{
+    redrawTimer = new QTimer(this);
+    redrawTimer->setSingleShot(true);
+    redrawTimer->setInterval(Const::REDRAW_DELAY_MS);
+    connect(redrawTimer, &QTimer::timeout, this, [this]() { update(); });
+    setCursor(Qt::OpenHandCursor);
+    layoutThread.setMaxThreadCount(1);
+}
+
+GraphWidget::~GraphWidget()
+{
+    stopLayout(); // the layout thread posts snapshots to this widget
+}
 
-// Set the graph data (adjacency list) and refresh the widget
+// Set the graph data (adjacency list), lay it out and refresh the widget
 void GraphWidget::setGraph(const vector<vector<Edge>> &g){
+    stopLayout();
     graph = g;
-    update(); // Trigger repaint
+    path.clear();
+    layoutGraph();
+    fitToView();
+    startLayout();
+}
+
+void GraphWidget::stopLayout()
+{
+    if (layoutProgress) {
+        layoutProgress->cancel();
+        layoutProgress.reset();
+    }
+    layoutTask.waitForFinished();
+    layoutGeneration++; // drops snapshots still queued
+}
+
+// Refine the layout on the worker thread and post the positions every LAYOUT_SNAPSHOT_MS until it converges
+void GraphWidget::startLayout()
+{
+    if (graph.size() < 2) {
+        return;
+    }
+    shared_ptr<Progress> current = make_shared<Progress>();
+    layoutProgress = current;
+    int generation = layoutGeneration;
+    CSRGraph csr(graph);
+    layoutTask = QtConcurrent::run(&layoutThread, [this, current, generation, csr]() {
+        ThreadPool pool;
+        LayoutOptions options;
+        options.edgeLength = Const::LAYOUT_EDGE_LENGTH;
+        ForceLayout layout(csr, pool, options);
+        QElapsedTimer clock;
+        while (!layout.converged() && !current->cancelled()) {
+            clock.start();
+            while (!layout.converged() && !current->cancelled() && clock.elapsed() < Const::LAYOUT_SNAPSHOT_MS) {
+                layout.run(1);
+            }
+            vector<QPointF> snapshot;
+            snapshot.reserve(layout.positions().size());
+            for (const LayoutPoint &point : layout.positions()) {
+                snapshot.emplace_back(point.x, point.y);
+            }
+            QMetaObject::invokeMethod(this, [this, generation, snapshot]() {
+                if (generation == layoutGeneration) {
+                    applyLayout(snapshot);
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+// Move the nodes to a layout snapshot; a fitted view follows the layout as it grows or shrinks
+void GraphWidget::applyLayout(const vector<QPointF> &layout)
+{
+    positions = layout;
+    computeGeometry();
+    if (fitted) {
+        fitToView();
+    } else {
+        update();
+    }
 }
 
-// Set the path to highlight and refresh the widget
+// Set the path to highlight and refresh the widget; the cached layer stays valid
 void GraphWidget::setPath(const vector<int> &p){
     path = p;
     update(); // Trigger repaint
 }
 
+// The zoom at which the whole layout fits, but no larger than the natural size
+double GraphWidget::fitScale() const
+{
+    if (bounds.isEmpty() || width() <= 0 || height() <= 0) {
+        return 1;
+    }
+    return min({1.0, width() / bounds.width(), height() / bounds.height()});
+}
 
-void GraphWidget::paintEvent(QPaintEvent *event) {
-    QPainter painter(this);
-    int radius = Const::NODE_RADIUS; // Raidus of each node circle
-    int n = graph.size(); // Number of nodes
+void GraphWidget::fitToView()
+{
+    scale = fitScale();
+    offset = QPointF(width() / 2.0, height() / 2.0) - bounds.center() * scale;
+    fitted = true;
+    layerValid = false; // a new graph or size is drawn at once, whatever its size
+    update();
+}
 
-    if (n == 0) return; // Nothing to draw
+// Place the nodes on a circle, large enough that neighbours keep a gap, and compute every edge's geometry
+void GraphWidget::layoutGraph()
+{
+    int n = graph.size(); // Number of nodes
+    double graphRadius = max<double>(Const::GRAPH_RADIUS, n * Const::NODE_SPACING / (2 * M_PI));
 
     // Calculate positions of nodes placed in a circular layout
-    vector<QPoint> positions(n);
+    positions.resize(n);
     for (int i = 0; i < n; ++i) {
         double angle = 2 * M_PI * i / n;
-        int graph_radius = Const::GRAPH_RADIUS;
-        int x = width() / 2 + graph_radius * cos(angle);
-        int y = height() / 2 + graph_radius * sin(angle);
-        positions[i] = QPoint(x, y);
+        positions[i] = QPointF(graphRadius * cos(angle), graphRadius * sin(angle));
+    }
 
-        // Draw the node
-        painter.setBrush(Qt::white);
-        painter.drawEllipse(positions[i], radius, radius);
-        painter.drawText(x - 5, y + 5, QString::number(i)); // Node label
+    // Reverse-edge lookup, built before the geometry needs it
+    edgeAt.clear();
+    size_t edgeCount = 0;
+    for (const auto &list : graph) {
+        edgeCount += list.size();
+    }
+    edgeAt.reserve(edgeCount);
+    for (int from = 0, index = 0; from < n; ++from) {
+        for (const auto &edge : graph[from]) {
+            edgeAt.emplace(edgeKey(from, edge.toNode), index++); // the first of parallel edges wins
+        }
     }
+    computeGeometry();
+}
 
-    // Lambda to check for reverse edge
-    auto hasReverse = [&](int from, int to) {
-        for (const auto& e : graph[to]) {
-            if (e.toNode == from) return true;
+// Compute the bounds and every edge's geometry from the node positions
+void GraphWidget::computeGeometry()
+{
+    int n = positions.size();
+    double radius = Const::NODE_RADIUS; // Raidus of each node circle
+    bounds = QRectF();
+    if (n > 0) {
+        double left = positions[0].x(), right = left, top = positions[0].y(), bottom = top;
+        for (const QPointF &position : positions) {
+            left = min(left, position.x());
+            right = max(right, position.x());
+            top = min(top, position.y());
+            bottom = max(bottom, position.y());
         }
-        return false;
-    };
+        bounds = QRectF(QPointF(left, top), QPointF(right, bottom)).adjusted(-radius, -radius, radius, radius);
+    }
 
-    // Draw all edges with weights and arrows
+    edges.clear();
+    edges.reserve(edgeAt.size());
     for (int from = 0; from < n; ++from) {
         for (const auto &edge : graph[from]) {
-            QPointF p1 = positions[from];
-            QPointF p2 = positions[edge.toNode];
-
-            // Default drawing points
-            QLineF edgeLine(p1, p2); // Line between node centers
+            QLineF edgeLine(positions[from], positions[edge.toNode]); // Line between node centres
             QLineF unitLine = edgeLine.unitVector(); // Unit vector of the edge
             QPointF direction = unitLine.p2() - unitLine.p1(); // Normalized direction vector
-            QPointF drawP1 = edgeLine.p1() + direction * Const::NODE_RADIUS; // Start after leaving source circle
-            QPointF drawP2 = edgeLine.p2() - direction * Const::NODE_RADIUS; // End before hitting target circle
+            QPointF drawP1 = edgeLine.p1() + direction * radius; // Start after leaving source circle
+            QPointF drawP2 = edgeLine.p2() - direction * radius; // End before hitting target circle
+            QPointF mid = (drawP1 + drawP2) / 2;
 
-            // Offset for bidirectional edges to separate overlapping lines
-            bool isBidirectional = hasReverse(from, edge.toNode);
-            if (isBidirectional && from < edge.toNode) {
+            // Offset both the line and its label of one of a pair of bidirectional edges
+            if (from < edge.toNode && edgeAt.count(edgeKey(edge.toNode, from))) {
                 QPointF offset(-edgeLine.dy(), edgeLine.dx()); // Perpendicular vector
                 double len = std::hypot(offset.x(), offset.y());
-                offset = (len != 0) ? offset / len * 10 : QPointF(0, 0); // Normalize and scale
+                offset = (len != 0) ? offset / len * Const::BIDIRECTIONAL_OFFSET : QPointF(0, 0); // Normalize and scale
                 drawP1 += offset;
                 drawP2 += offset;
+                mid += offset * 2; // the mid-point of the shifted line, shifted once more
             }
+            edges.push_back({QLineF(drawP1, drawP2), mid, edge.weight});
+        }
+    }
+    layerValid = false;
+}
+
+// The part of the layout the widget shows
+QRectF GraphWidget::visibleArea() const
+{
+    return QRectF(-offset / scale, QSizeF(width(), height()) / scale);
+}
 
-            // Draw the edge line
-            painter.setPen(QPen(Qt::black, 2));
-            painter.drawLine(drawP1, drawP2);
+// Redraw the layer for the current view: only what is visible, with detail depending on the zoom
+void GraphWidget::renderLayer()
+{
+    qreal ratio = devicePixelRatioF();
+    if (layer.size() != size() * ratio) {
+        layer = QPixmap(size() * ratio);
+        layer.setDevicePixelRatio(ratio);
+    }
+    layer.fill(Qt::transparent);
+    layerScale = scale;
+    layerOffset = offset;
+    layerValid = true;
 
-            // Draw directional arrow
-            drawArrow(painter, drawP1, drawP2);
+    QPainter painter(&layer);
+    painter.setFont(font());
+    painter.setRenderHint(QPainter::Antialiasing, scale >= Const::LABEL_MIN_ZOOM);
+    painter.setTransform(QTransform(scale, 0, 0, scale, offset.x(), offset.y()));
 
-            // Determine mid-point of edge to draw the weight label
-            QPointF mid = (drawP1 + drawP2) / 2;
+    // Grow the area by a node so circles and labels straddling the border are drawn
+    double radius = Const::NODE_RADIUS; // Raidus of each node circle
+    QRectF area = visibleArea().adjusted(-2 * radius, -2 * radius, 2 * radius, 2 * radius);
+    bool labels = scale >= Const::LABEL_MIN_ZOOM;
+    bool arrows = scale >= Const::ARROW_MIN_ZOOM;
+    bool circles = radius * scale >= Const::MIN_NODE_PIXELS;
 
-            // Offset the label if this is one of a pair of bidirectional edges
-            if (isBidirectional && from < edge.toNode) {
-                QPointF offset(-edgeLine.dy(), edgeLine.dx()); // Perpendicular direction for offset
-                double len = std::hypot(offset.x(), offset.y());
-                if (len != 0)
-                    mid += offset / len * 10; // Normalize and apply offset to shift label
+    // Draw the nodes, as circles with their ids or, zoomed far out, as dots
+    int n = positions.size();
+    if (circles) {
+        QPen nodePen(Qt::black, 1);
+        nodePen.setCosmetic(true);
+        painter.setPen(nodePen);
+        painter.setBrush(Qt::white);
+        for (int i = 0; i < n; ++i) {
+            if (area.contains(positions[i])) {
+                painter.drawEllipse(positions[i], radius, radius);
+                if (labels) {
+                    painter.drawText(positions[i] + QPointF(-5, 5), QString::number(i)); // Node label
+                }
+            }
+        }
+    } else {
+        vector<QPointF> dots;
+        for (int i = 0; i < n; ++i) {
+            if (area.contains(positions[i])) {
+                dots.push_back(positions[i]);
             }
+        }
+        QPen dotPen(Qt::black, 2);
+        dotPen.setCosmetic(true); // two pixels at any zoom
+        painter.setPen(dotPen);
+        painter.drawPoints(dots.data(), static_cast<int>(dots.size()));
+    }
 
+    // Draw all visible edges in one call, then their arrows and weight labels
+    vector<int> visible;
+    vector<QLineF> lines;
+    for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
+        if (overlaps(edges[i].line, area)) {
+            visible.push_back(i);
+            lines.push_back(edges[i].line);
+        }
+    }
+    QPen edgePen(Qt::black, labels ? 2 : 1);
+    edgePen.setCosmetic(true);
+    painter.setPen(edgePen);
+    painter.drawLines(lines.data(), static_cast<int>(lines.size()));
 
-            // Draw the weight label
-            QString weightText = QString::number(edge.weight);
-            painter.setPen(Qt::black);
-            painter.setFont(QFont(Const::FONT_FAMILY(), Const::FONT_SIZE));
-            painter.drawText(mid, weightText);
+    if (arrows) {
+        painter.setBrush(Qt::black);
+        for (int i : visible) {
+            painter.drawPolygon(arrowHead(edges[i].line.p1(), edges[i].line.p2()));
         }
     }
+    if (labels) {
+        painter.setPen(Qt::black);
+        painter.setFont(labelFont);
+        for (int i : visible) {
+            painter.drawText(edges[i].labelAt, QString::number(edges[i].weight));
+        }
+    }
+}
 
-    // If a path is provided, draw it in blue
-    if (!path.empty()) {
-        painter.setPen(QPen(Qt::blue, 3)); // Use a blue pen for highlighting the path
-        for (int i = 0; i + 1 < path.size(); ++i) {
-            int from = path[i];
-            int to = path[i + 1];
+// A view change on a small graph is redrawn at once; on a large one the layer is stretched and
+// moved until the view rests for a moment
+void GraphWidget::viewChanged()
+{
+    fitted = false;
+    if (positions.size() + edges.size() > static_cast<size_t>(Const::IMMEDIATE_REDRAW_ITEMS)) {
+        redrawTimer->start();
+    }
+    update();
+}
 
-            QPointF p1 = positions[from];
-            QPointF p2 = positions[to];
+void GraphWidget::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+    if (positions.empty()) return; // Nothing to draw
 
-            QLineF pathLine(p1, p2); // Full line from source to destination
-            QLineF unit = pathLine.unitVector(); // Unit vector in the same direction
-            QPointF direction = unit.p2() - unit.p1(); // Normalized direction vector
+    bool moved = layerScale != scale || layerOffset != offset;
+    if (!layerValid || layer.size() != size() * devicePixelRatioF() || (moved && !redrawTimer->isActive())) {
+        renderLayer();
+    }
 
-            // Trim the path ends to stop short of the node circles
-            QPointF drawP1 = p1 + direction * radius;
-            QPointF drawP2 = p2 - direction * radius;
+    // Show the layer where the current view puts it
+    QPainter painter(this);
+    double ratio = scale / layerScale;
+    painter.setTransform(QTransform(ratio, 0, 0, ratio, offset.x() - layerOffset.x() * ratio, offset.y() - layerOffset.y() * ratio));
+    painter.drawPixmap(0, 0, layer);
 
-            // If there's a reverse edge, offset the line so it doesn't overlap with the other direction
-            if (hasReverse(from, to) && from < to) {
-                QPointF offset(-pathLine.dy(), pathLine.dx()); // Perpendicular offset direction
-                double len = std::hypot(offset.x(), offset.y());
-                if (len != 0) {
-                    offset /= len; // Normalize the offset vector
-                    offset *= 10;  // Scale the offset distance
-                    drawP1 += offset; // Apply to both ends
-                    drawP2 += offset;
-                }
+    // If a path is provided, draw it in blue over the edges it takes
+    if (path.size() > 1) {
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setTransform(QTransform(scale, 0, 0, scale, offset.x(), offset.y()));
+        QPen pathPen(Qt::blue, 3); // Use a blue pen for highlighting the path
+        pathPen.setCosmetic(true);
+        painter.setPen(pathPen);
+        vector<QLineF> lines;
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            auto found = edgeAt.find(edgeKey(path[i], path[i + 1]));
+            if (found != edgeAt.end()) {
+                lines.push_back(edges[found->second].line);
             }
-
-            painter.drawLine(drawP1, drawP2); // Draw the line
         }
+        painter.drawLines(lines.data(), static_cast<int>(lines.size()));
+    }
+}
+
+void GraphWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    if (fitted) {
+        fitToView();
+    }
+}
+
+// Zoom around the cursor, one step per wheel notch
+void GraphWidget::wheelEvent(QWheelEvent *event)
+{
+    double minScale = fitScale() * Const::MIN_ZOOM;
+    double newScale = scale * pow(Const::ZOOM_STEP, event->angleDelta().y() / 120.0);
+    newScale = max(minScale, min<double>(Const::MAX_ZOOM, newScale));
+    QPointF cursor = event->position();
+    offset = cursor - (cursor - offset) * (newScale / scale); // the point under the cursor stays put
+    scale = newScale;
+    viewChanged();
+    event->accept();
+}
+
+void GraphWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        dragging = true;
+        dragFrom = event->position();
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void GraphWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (dragging) {
+        offset += event->position() - dragFrom;
+        dragFrom = event->position();
+        viewChanged();
+    }
+}
+
+void GraphWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && dragging) {
+        dragging = false;
+        setCursor(Qt::OpenHandCursor);
+    }
+}
+
+void GraphWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        fitToView();
     }
 }
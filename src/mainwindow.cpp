@@ -1,9 +1,48 @@
+#include <QFileDialog>
+#include <QFutureWatcher>
+#include <QIntValidator>
 #include <QLayout>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QRandomGenerator>
 #include <QStackedLayout>
+#include <QStatusBar>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrentRun>
+#include <exception>
 #include "../include/mainwindow.h"
 #include "ui_mainwindow.h"
 #include "../include/constants.h"
 #include "../include/algorithm.h"
+#include "../include/graphimport.h"
+#include "../include/parallel.h"
+#include "../include/searchstats.h"
+
+// A generated or loaded graph, built on the worker thread
+struct GraphResult {
+    CSRGraph csr;
+    vector<vector<Edge>> drawn; // the adjacency list, only for graphs small enough to draw
+};
+
+// The answer to a path query, computed on the worker thread
+struct PathResult {
+    pair<vector<int>, int> path;
+    SearchStats stats;
+    bool counted = true; // the parallel Bellman-Ford has no counters
+    bool cached = false; // answered from a cached tree, so nothing was searched
+    bool negativeCycle = false;
+};
+
+// The search counters shown below the distance, one per line
+static QString statsText(const SearchStats& stats)
+{
+    return QString("\nNodes settled: %1\nEdges relaxed: %2\nImprovements: %3\nQueue pushes: %4\n"
+                   "Stale entries: %5\nPeak queue: %6")
+        .arg(stats.nodesSettled).arg(stats.edgesRelaxed).arg(stats.successfulRelaxations)
+        .arg(stats.queuePushes).arg(stats.staleEntries).arg(stats.peakQueueSize);
+}
 
 // Constructor for the MainWindow class
 MainWindow::MainWindow(QWidget *parent)
@@ -14,17 +53,18 @@ MainWindow::MainWindow(QWidget *parent)
     setWindowTitle(Const::WINDOW_TITLE()); // Set window title
 
     // Configure node count spin box
-    ui->nodeSpinBox->setRange(Const::MIN_NODES_NUM, Const::MAX_NODES_NUM); // Allow between 3 and 10 nodes
-    ui->nodeSpinBox->setValue(Const::DEFAULT_NODES_NUM);   // Default value is 5
+    ui->nodeSpinBox->setRange(Const::MIN_NODES_NUM, Const::MAX_NODES_NUM);
+    ui->nodeSpinBox->setValue(Const::DEFAULT_NODES_NUM);
 
-    ui->generateButton->setToolTip("Generate a graph with 3-10 nodes");
+    ui->generateButton->setToolTip(QString("Generate a graph with %1-%2 nodes").arg(Const::MIN_NODES_NUM).arg(Const::MAX_NODES_NUM));
+    ui->loadButton->setToolTip("Load a graph from a DIMACS .gr, edge list or binary graph file");
     ui->computeButton->setToolTip("Compute shortest path between selected nodes");
 
     graphWidget = new GraphWidget(this);
     graphWidget->setMinimumSize(Const::MIN_WIDGET_WIDTH, Const::MIN_WIDGET_HEIGHT); // Set a minimum size
 
     // Use a QStackedLayout to toggle between instruction text and graph view
-    QStackedLayout *stackedLayout = new QStackedLayout(ui->graphContainer);
+    stackedLayout = new QStackedLayout(ui->graphContainer);
     stackedLayout->addWidget(ui->instructionLabel); // index 0: instructions shown initially
     stackedLayout->addWidget(graphWidget);          // index 1: graph view after generation
     stackedLayout->setCurrentIndex(0); // Start with instruction
@@ -32,64 +72,138 @@ MainWindow::MainWindow(QWidget *parent)
     // Hide the distance label
     ui->distanceLabel->hide();
 
+    // Progress bar and cancel button of the running task, shown only while one runs
+    progressBar = new QProgressBar(this);
+    progressBar->setMaximumWidth(Const::PROGRESS_BAR_WIDTH);
+    cancelButton = new QPushButton("Cancel", this);
+    statusBar()->addPermanentWidget(progressBar);
+    statusBar()->addPermanentWidget(cancelButton);
+    progressBar->hide();
+    cancelButton->hide();
+    progressTimer = new QTimer(this);
+    progressTimer->setInterval(Const::PROGRESS_INTERVAL_MS);
+    connect(progressTimer, &QTimer::timeout, this, &MainWindow::updateProgress);
+    connect(cancelButton, &QPushButton::clicked, this, [=](){
+        if(progress){
+            progress->cancel(); // the task stops at its next check
+            cancelButton->setEnabled(false);
+            statusBar()->showMessage("Cancelling...");
+        }
+    });
+
     // When "Generate Graph" button is clicked
     connect(ui->generateButton, &QPushButton::clicked, this, [=](){
         int nodes = ui->nodeSpinBox->value(); // Read number of nodes
-        QString type = ui->graphTypeComboBox->currentText(); // Graph type: DAG or normal
-
-        // Generate appropriate graph
-        if(type == "Directed Acyclic Graph"){
-            graph = generateDAGraph(nodes, Const::DAG_AVG_DEGREE, Const::DAG_MIN_WEIGHT, Const::DAG_MAX_WEIGHT); // DAG with possible negative weights
-        }
-        else{
-            graph = generateDirectedGraph(nodes, Const::DG_AVG_DEGREE, Const::DG_MIN_WEIGHT, Const::DG_MAX_WEIGHT); // Standard directed graph
-        }
+        bool dag = ui->graphTypeComboBox->currentText() == "Directed Acyclic Graph"; // Graph type: DAG or normal
+        unsigned long long seed = QRandomGenerator::global()->generate64();
 
-        // Update graph view
-        graphWidget->setGraph(graph);
-        graphWidget->setPath({}); // Clear existing path (if any)
-        stackedLayout->setCurrentIndex(1); // Switch from instruction text to graph view
+        runInBackground<GraphResult>("Generating graph", [=](Progress& taskProgress){
+            // Generate appropriate graph
+            GraphResult result;
+            if(dag){
+                result.csr = generateDAGraphCSR(nodes, Const::DAG_AVG_DEGREE, Const::DAG_MIN_WEIGHT, Const::DAG_MAX_WEIGHT,
+                                                seed, 0, &taskProgress); // DAG with possible negative weights
+            }
+            else{
+                result.csr = generateDirectedGraphCSR(nodes, Const::DG_AVG_DEGREE, Const::DG_MIN_WEIGHT, Const::DG_MAX_WEIGHT,
+                                                      seed, 0, &taskProgress); // Standard directed graph
+            }
+            if(nodes <= Const::MAX_DRAWN_NODES){
+                result.drawn = result.csr.toAdjacencyList();
+            }
+            return result;
+        }, [=](GraphResult result){
+            showGraph(result.csr, result.drawn, "Generated");
+        });
+    });
 
-        // Populate the combo boxes with node indices for path selection
-        ui->fromComboBox->clear();
-        ui->toComboBox->clear();
-        for(int i = 0; i < nodes; i++){
-            QString label = QString::number(i);
-            ui->fromComboBox->addItem(label);
-            ui->toComboBox->addItem(label);
+    // When "Load Graph..." button is clicked
+    connect(ui->loadButton, &QPushButton::clicked, this, [=](){
+        QString path = QFileDialog::getOpenFileName(this, "Load Graph", QString(),
+                                                    "Graph files (*.gr *.txt *.el *.csr);;All files (*)");
+        if(path.isEmpty()){
+            return;
         }
-        ui->distanceLabel->hide();
+
+        // Reading a file has no check points: a cancelled load finishes and is then discarded
+        runInBackground<GraphResult>("Loading graph", [=](Progress&){
+            GraphResult result;
+            result.csr = importGraph(path.toStdString());
+            if(result.csr.numNodes() <= Const::MAX_DRAWN_NODES){
+                result.drawn = result.csr.toAdjacencyList();
+            }
+            return result;
+        }, [=](GraphResult result){
+            showGraph(result.csr, result.drawn, "Loaded");
+        });
     });
 
     // When "Compute Path" button is clicked
     connect(ui->computeButton, &QPushButton::clicked, this, [=](){
+        int nodes = currentGraph.numNodes();
+        if(nodes == 0){
+            return; // nothing generated or loaded yet
+        }
         int from = ui->fromComboBox->currentText().toInt(); // Source node
         int to = ui->toComboBox->currentText().toInt();     // Destination node
-        QString type = ui->graphTypeComboBox->currentText();// DAR or normal
-
-        pair<vector<int>, int> result;
-
-        // Run appropriate algorithm
-        if(type == "Directed Acyclic Graph"){
-            result = BellmanFord(graph.size(), from, to, graph);
-        }
-        else{
-            result = Dijkstra(graph.size(), from, to, graph);
-            graphWidget->setPath(result.first);
+        if(from < 0 || from >= nodes || to < 0 || to >= nodes){
+            ui->distanceLabel->setText("Node ids must be between 0 and " + QString::number(nodes - 1) + ".");
+            ui->distanceLabel->show();
+            return;
         }
 
-        // Update path visualization
-        const vector<int>& path = result.first;
-        graphWidget->setPath(path);
+        CSRGraph queried = currentGraph; // shares the arrays with the current graph
+        runInBackground<PathResult>("Computing path", [=](Progress& taskProgress){
+            PathResult result;
+            if(queried.minWeight() >= 0 || queried.isTopologicallyOrdered()){
+                // Without negative weights, or with all edges from lower to higher ids (generated DAGs),
+                // there is no negative cycle, so the cache's DAG, Dijkstra or Bellman-Ford trees are exact
+                result.cached = treeCache.contains(from);
+                result.path = treeCache.query(from, to, &result.stats, &taskProgress);
+            }
+            else{
+                // Files may contain negative cycles, which the frontier Bellman-Ford reports
+                BellmanFordResult bellmanFord = BellmanFordFrontier(nodes, from, to, queried, 0, &taskProgress);
+                result.negativeCycle = bellmanFord.negativeCycle;
+                result.path = {bellmanFord.path, bellmanFord.distance};
+                result.counted = false;
+            }
+            return result;
+        }, [=](PathResult result){
+            if(result.negativeCycle){
+                graphWidget->setPath({});
+                ui->distanceLabel->setText("A negative cycle is reachable from node " + QString::number(from) + ".");
+                ui->distanceLabel->show();
+                return;
+            }
 
-        // Show distance result to user
-        int distance = result.second;
-        if (path.empty() || distance == std::numeric_limits<int>::max()) {
-            ui->distanceLabel->setText("Unreachable.");
-        } else {
-            ui->distanceLabel->setText("Shortest distance: " + QString::number(distance));
-        }
-        ui->distanceLabel->show();
+            // Update path visualization
+            const vector<int>& path = result.path.first;
+            if(!graph.empty()){ // large graphs are not drawn
+                graphWidget->setPath(path);
+            }
+
+            // Show distance result to user
+            int distance = result.path.second;
+            QString text;
+            if (path.empty() || distance == std::numeric_limits<int>::max()) {
+                text = "Unreachable.";
+            } else {
+                text = "Shortest distance: " + QString::number(distance);
+            }
+            if(result.cached){
+                text += "\nAnswered from the cached tree of node " + QString::number(from) + ".";
+            }
+            else if(result.counted){
+                text += statsText(result.stats);
+            }
+            text += QString("\nTree cache: %1 trees, %2 KB, %3% hits")
+                        .arg(treeCache.size())
+                        .arg(treeCache.memoryBytes() / 1024)
+                        .arg(treeCache.hitRate() * 100, 0, 'f', 0);
+            ui->distanceLabel->setText(text);
+            ui->distanceLabel->show();
+        });
     });
 
 }
@@ -97,6 +211,130 @@ MainWindow::MainWindow(QWidget *parent)
 // Destructor to clean up UI
 MainWindow::~MainWindow()
 {
+    // A running task uses the tree cache; stop it and wait before the members go away
+    if(progress){
+        progress->cancel();
+    }
+    QThreadPool::globalInstance()->waitForDone();
     delete ui;
 }
 
+template<typename Result>
+void MainWindow::runInBackground(const QString &task, std::function<Result(Progress &)> work, std::function<void(Result)> done)
+{
+    std::shared_ptr<Progress> current = std::make_shared<Progress>();
+    progress = current;
+    setBusy(task);
+
+    // QtConcurrent only carries QException across threads, so every other exception is brought back by hand
+    using Outcome = std::pair<Result, std::exception_ptr>;
+    auto *watcher = new QFutureWatcher<Outcome>(this);
+    connect(watcher, &QFutureWatcher<Outcome>::finished, this, [=](){
+        Outcome outcome = watcher->result();
+        watcher->deleteLater();
+        progress.reset();
+        setIdle();
+
+        if(current->cancelled()){
+            statusBar()->showMessage(task + " cancelled.", Const::STATUS_MESSAGE_MS);
+            return;
+        }
+        if(outcome.second){
+            try{
+                std::rethrow_exception(outcome.second);
+            }
+            catch(const std::exception& error){
+                QMessageBox::warning(this, task, error.what());
+            }
+            return;
+        }
+        done(std::move(outcome.first));
+    });
+    watcher->setFuture(QtConcurrent::run([current, work]() -> Outcome {
+        try{
+            return {work(*current), nullptr};
+        }
+        catch(...){
+            return {Result(), std::current_exception()};
+        }
+    }));
+}
+
+void MainWindow::showGraph(const CSRGraph &csr, const std::vector<std::vector<Edge>> &drawn, const QString &origin)
+{
+    int nodes = csr.numNodes();
+    currentGraph = csr;
+    treeCache.setGraph(csr); // trees of the previous graph are invalid now
+
+    // Small graphs are drawn; larger ones are only queried
+    graph = drawn;
+    graphWidget->setGraph(graph);
+    graphWidget->setPath({}); // Clear existing path (if any)
+    if(!graph.empty()){
+        stackedLayout->setCurrentIndex(1); // Switch from instruction text to graph view
+    }
+    else{
+        ui->instructionLabel->setText(QString("%1 %2 nodes and %3 edges.\n\nThe graph is too large to draw; "
+                                              "enter two node ids and click \"Compute Path\".")
+                                          .arg(origin).arg(nodes).arg(csr.numEdges()));
+        stackedLayout->setCurrentIndex(0);
+    }
+
+    // List the node ids if there are few, otherwise let them be typed in
+    bool listed = nodes <= Const::MAX_LISTED_NODES;
+    for(QComboBox* box : {ui->fromComboBox, ui->toComboBox}){
+        box->clear();
+        box->setEditable(!listed);
+        if(listed){
+            for(int i = 0; i < nodes; i++){
+                box->addItem(QString::number(i));
+            }
+        }
+        else{
+            box->setValidator(new QIntValidator(0, qMax(nodes - 1, 0), box));
+            box->setEditText("0");
+        }
+    }
+    ui->distanceLabel->hide();
+}
+
+// Locks the buttons that start a task and shows the progress of the new one
+void MainWindow::setBusy(const QString &task)
+{
+    for(QPushButton* button : {ui->generateButton, ui->loadButton, ui->computeButton}){
+        button->setEnabled(false);
+    }
+    progressBar->setRange(0, 0); // busy indicator until the task reports its size
+    progressBar->show();
+    cancelButton->setEnabled(true);
+    cancelButton->show();
+    statusBar()->showMessage(task + "...");
+    progressTimer->start();
+}
+
+void MainWindow::setIdle()
+{
+    progressTimer->stop();
+    progressBar->hide();
+    cancelButton->hide();
+    statusBar()->clearMessage();
+    for(QPushButton* button : {ui->generateButton, ui->loadButton, ui->computeButton}){
+        button->setEnabled(true);
+    }
+}
+
+// Copies the progress of the running task into the progress bar
+void MainWindow::updateProgress()
+{
+    if(!progress){
+        return;
+    }
+    double fraction = progress->fraction();
+    if(fraction < 0){
+        progressBar->setRange(0, 0);
+    }
+    else{
+        progressBar->setRange(0, Const::PROGRESS_STEPS);
+        progressBar->setValue(static_cast<int>(fraction * Const::PROGRESS_STEPS));
+    }
+}
@@ -0,0 +1,80 @@
+#include "../include/mappedfile.h"
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+MappedFile::MappedFile(const string &path)
+{
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw runtime_error("cannot open " + path);
+    }
+    file = handle;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(handle, &fileSize);
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length > 0) {
+        mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        bytes = mapping ? static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        if (!bytes) {
+            close();
+            throw runtime_error("cannot map " + path);
+        }
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("cannot open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw runtime_error("cannot stat " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void *address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throw runtime_error("cannot map " + path);
+        }
+        bytes = static_cast<const char *>(address);
+    }
+    ::close(fd); // the mapping stays valid without the descriptor
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (bytes) {
+        UnmapViewOfFile(bytes);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    if (file) {
+        CloseHandle(file);
+    }
+    file = nullptr;
+    mapping = nullptr;
+#else
+    if (bytes) {
+        munmap(const_cast<char *>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+}
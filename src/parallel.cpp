@@ -0,0 +1,426 @@
+#include "../include/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+using namespace std;
+
+// Nodes per chunk handed to a worker; small enough to balance high-degree nodes
+static const int FRONTIER_GRAIN = 256;
+
+// A Bellman-Ford frontier larger than num_nodes / this is processed by sweeping all nodes
+static const int DENSE_FRONTIER_FRACTION = 16;
+
+// Consecutive nodes per chunk of a full sweep, so each worker walks a contiguous range in order
+static const int DENSE_SWEEP_GRAIN = 4096;
+
+// Upper bound on the bucket ring; buckets further ahead share slots and are told apart by distance
+static const int MAX_BUCKET_SLOTS = 4096;
+
+// A tentative distance and its predecessor packed into one word, so both change in a single
+// atomic step. The distance is stored with its sign bit flipped so that smaller words are
+// better paths (shorter distance first, then smaller predecessor) for negative distances too,
+// and the all-ones word reads as (INF, -1)
+static const uint64_t UNREACHED = numeric_limits<uint64_t>::max();
+
+static inline uint64_t packLabel(const int distance, const int predecessor)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(distance) ^ 0x80000000u) << 32) | static_cast<uint32_t>(predecessor);
+}
+
+static inline int labelDistance(const uint64_t label)
+{
+    return static_cast<int>(static_cast<uint32_t>(label >> 32) ^ 0x80000000u);
+}
+
+static inline int labelPredecessor(const uint64_t label)
+{
+    return static_cast<int>(static_cast<uint32_t>(label));
+}
+
+// Lower the label of a node to (distance, predecessor) if the distance is shorter, or, with
+// tieBreak, if it is equal and the predecessor smaller; returns true if the distance went down.
+// Ties must only be broken over positive-weight edges: across zero-weight edges two nodes
+// could each take the other as predecessor
+static inline bool relaxLabel(atomic<uint64_t> &label, const int distance, const int predecessor, const bool tieBreak)
+{
+    const uint64_t candidate = packLabel(distance, predecessor);
+    uint64_t current = label.load(memory_order_relaxed);
+    while (tieBreak ? candidate < current : distance < labelDistance(current)) {
+        if (label.compare_exchange_weak(current, candidate, memory_order_relaxed)) {
+            return labelDistance(current) > distance;
+        }
+    }
+    return false;
+}
+
+static vector<atomic<uint64_t>> unreachedLabels(const int num_nodes, ThreadPool &pool)
+{
+    vector<atomic<uint64_t>> label(num_nodes);
+    pool.parallelFor(num_nodes, 1 << 14, [&](int begin, int end, int) {
+        for (int v = begin; v < end; v++) {
+            label[v].store(UNREACHED, memory_order_relaxed);
+        }
+    });
+    return label;
+}
+
+static ShortestPathTree labelsToTree(const vector<atomic<uint64_t>> &label, ThreadPool &pool)
+{
+    const int num_nodes = label.size();
+    ShortestPathTree tree;
+    tree.distance.resize(num_nodes);
+    tree.predecessor.resize(num_nodes);
+    pool.parallelFor(num_nodes, 1 << 14, [&](int begin, int end, int) {
+        for (int v = begin; v < end; v++) {
+            uint64_t packed = label[v].load(memory_order_relaxed);
+            tree.distance[v] = labelDistance(packed);
+            tree.predecessor[v] = labelPredecessor(packed);
+        }
+    });
+    return tree;
+}
+
+// Parallel delta-stepping. Every worker keeps its own ring of buckets so pushes need no locks;
+// the lowest bucket is gathered from all rings (dropping stale and duplicate entries) between rounds
+ShortestPathTree DeltaSteppingTree(const CSRGraph &graph, const int source, int delta, ThreadPool &pool)
+{
+    const int INF = numeric_limits<int>::max();
+    const int num_nodes = graph.numNodes();
+    const int num_workers = pool.size();
+
+    if (delta <= 0) {
+        int averageDegree = max(1, graph.numEdges() / max(1, num_nodes));
+        delta = max(1, graph.maxWeight() / averageDegree);
+    }
+    const int slots = static_cast<int>(min<long long>(MAX_BUCKET_SLOTS, graph.maxWeight() / delta + 2));
+
+    vector<atomic<uint64_t>> label = unreachedLabels(num_nodes, pool);
+    label[source].store(packLabel(0, -1), memory_order_relaxed);
+
+    vector<vector<vector<int>>> buckets(num_workers, vector<vector<int>>(slots));
+    vector<long long> pushed(num_workers, 0);
+    buckets[0][0].push_back(source);
+    long long pending = 1; // entries in all rings, stale ones included
+
+    // Relax the edges of one node whose weight is on the requested side of delta
+    auto relaxEdges = [&](int from_node, bool light, int worker) {
+        const int fromDistance = labelDistance(label[from_node].load(memory_order_relaxed));
+        for (int i = graph.edgesBegin(from_node); i < graph.edgesEnd(from_node); i++) {
+            int weight = graph.weight(i);
+            if ((weight <= delta) != light) {
+                continue;
+            }
+            long long newDist = static_cast<long long>(fromDistance) + weight;
+            if (newDist >= INF) {
+                continue;
+            }
+            int to_node = graph.target(i);
+            if (relaxLabel(label[to_node], static_cast<int>(newDist), from_node, weight > 0)) {
+                buckets[worker][(newDist / delta) % slots].push_back(to_node);
+                pushed[worker]++;
+            }
+        }
+    };
+
+    vector<int> roundStamp(num_nodes, -1); // last light round a node was gathered for
+    vector<char> finished(num_nodes, 0);   // node already belongs to a processed bucket
+    vector<int> frontier, settledInBucket;
+    int round = 0;
+    long long bucket = 0;
+    int emptyBuckets = 0;
+
+    while (pending > 0) {
+        settledInBucket.clear();
+
+        // Light rounds until the bucket stays empty
+        while (true) {
+            frontier.clear();
+            for (int w = 0; w < num_workers; w++) {
+                vector<int> &slot = buckets[w][bucket % slots];
+                pending -= slot.size();
+                size_t kept = 0;
+                for (int v : slot) {
+                    long long at = labelDistance(label[v].load(memory_order_relaxed)) / delta;
+                    if (at > bucket) {
+                        slot[kept++] = v; // a later bucket sharing this slot
+                    } else if (at == bucket && roundStamp[v] != round) {
+                        roundStamp[v] = round;
+                        frontier.push_back(v);
+                        if (!finished[v]) {
+                            finished[v] = 1;
+                            settledInBucket.push_back(v);
+                        }
+                    }
+                }
+                slot.resize(kept);
+                pending += kept;
+            }
+            round++;
+            if (frontier.empty()) {
+                break;
+            }
+
+            pool.parallelFor(static_cast<int>(frontier.size()), FRONTIER_GRAIN, [&](int begin, int end, int worker) {
+                for (int i = begin; i < end; i++) {
+                    relaxEdges(frontier[i], true, worker);
+                }
+            });
+            for (int w = 0; w < num_workers; w++) {
+                pending += pushed[w];
+                pushed[w] = 0;
+            }
+        }
+
+        // The bucket's distances are final now; heavy edges always lead to later buckets
+        pool.parallelFor(static_cast<int>(settledInBucket.size()), FRONTIER_GRAIN, [&](int begin, int end, int worker) {
+            for (int i = begin; i < end; i++) {
+                relaxEdges(settledInBucket[i], false, worker);
+            }
+        });
+        for (int w = 0; w < num_workers; w++) {
+            pending += pushed[w];
+            pushed[w] = 0;
+        }
+
+        // After a full ring of empty buckets, jump straight to the lowest pending one
+        emptyBuckets = settledInBucket.empty() ? emptyBuckets + 1 : 0;
+        if (emptyBuckets >= slots && pending > 0) {
+            long long lowest = numeric_limits<long long>::max();
+            for (int w = 0; w < num_workers; w++) {
+                for (const vector<int> &slot : buckets[w]) {
+                    for (int v : slot) {
+                        lowest = min(lowest, static_cast<long long>(labelDistance(label[v].load(memory_order_relaxed))) / delta);
+                    }
+                }
+            }
+            bucket = lowest;
+            emptyBuckets = 0;
+        } else {
+            bucket++;
+        }
+    }
+
+    return labelsToTree(label, pool);
+}
+
+pair<vector<int>, int> DeltaStepping(const int num_nodes,
+                                     const int source,
+                                     const int target,
+                                     const CSRGraph &graph,
+                                     const int delta,
+                                     const int num_threads)
+{
+    // Buckets need non-negative distances; negative weights go to Bellman-Ford instead
+    if (graph.minWeight() < 0) {
+        return BellmanFord(num_nodes, source, target, graph);
+    }
+    ThreadPool pool(num_threads);
+    return extractPath(DeltaSteppingTree(graph, source, delta, pool), target);
+}
+
+// Look for a cycle in the predecessor graph; returns its nodes in edge order, or nothing
+static vector<int> findPredecessorCycle(const vector<atomic<uint64_t>> &label)
+{
+    const int num_nodes = label.size();
+    vector<int> walk(num_nodes, -1); // the start node of the walk that first reached a node
+
+    for (int start = 0; start < num_nodes; start++) {
+        int at = start;
+        while (at != -1 && walk[at] == -1) {
+            walk[at] = start;
+            at = labelPredecessor(label[at].load(memory_order_relaxed));
+        }
+        if (at == -1 || walk[at] != start) {
+            continue; // reached the root or an earlier, already checked walk
+        }
+
+        // This walk ran into itself: `at` is on a cycle. Predecessors point backwards along edges
+        vector<int> cycle;
+        int node = at;
+        do {
+            cycle.push_back(node);
+            node = labelPredecessor(label[node].load(memory_order_relaxed));
+        } while (node != at);
+        reverse(cycle.begin(), cycle.end());
+        return cycle;
+    }
+    return {};
+}
+
+// Frontier-driven Bellman-Ford. dirty[v] marks nodes whose out-edges have not been relaxed
+// since their distance last changed. Small frontiers are kept as node lists; once a frontier
+// covers a large part of the graph, a round sweeps all nodes in index order instead, which also
+// picks up nodes improved earlier in the same sweep (a single sweep settles an ordered DAG)
+BellmanFordResult BellmanFordFrontier(const int num_nodes,
+                                      const int source,
+                                      const int target,
+                                      const CSRGraph &graph,
+                                      ThreadPool &pool,
+                                      Progress *progress)
+{
+    const int INF = numeric_limits<int>::max();
+    const int num_workers = pool.size();
+    if (progress) {
+        progress->start(0); // the number of rounds is not known upfront
+    }
+
+    vector<atomic<uint64_t>> label = unreachedLabels(num_nodes, pool);
+    label[source].store(packLabel(0, -1), memory_order_relaxed);
+
+    vector<atomic<char>> dirty(num_nodes);
+    pool.parallelFor(num_nodes, 1 << 14, [&](int begin, int end, int) {
+        for (int v = begin; v < end; v++) {
+            dirty[v].store(0, memory_order_relaxed);
+        }
+    });
+    dirty[source].store(1, memory_order_relaxed);
+
+    vector<vector<int>> next(num_workers);
+    vector<int> frontier = {source};
+    BellmanFordResult result;
+
+    for (int round = 1; !frontier.empty(); round++) {
+        if (progress) {
+            progress->throwIfCancelled();
+            progress->advance(1);
+        }
+        const bool dense = frontier.size() > static_cast<size_t>(num_nodes / DENSE_FRONTIER_FRACTION);
+
+        // Clearing the flag before reading the distance means a concurrent improvement
+        // either is seen here or sets the flag again (acq_rel pairs the flag with the label)
+        auto relaxFrom = [&](int from_node, int worker) {
+            const int fromDistance = labelDistance(label[from_node].load(memory_order_relaxed));
+            for (int e = graph.edgesBegin(from_node); e < graph.edgesEnd(from_node); e++) {
+                long long newDist = static_cast<long long>(fromDistance) + graph.weight(e);
+                if (newDist >= INF || newDist <= numeric_limits<int>::min()) {
+                    continue;
+                }
+                int to_node = graph.target(e);
+                if (relaxLabel(label[to_node], static_cast<int>(newDist), from_node, false)
+                    && dirty[to_node].exchange(1, memory_order_acq_rel) == 0 && !dense) {
+                    next[worker].push_back(to_node);
+                }
+            }
+        };
+
+        if (dense) {
+            pool.parallelFor(num_nodes, DENSE_SWEEP_GRAIN, [&](int begin, int end, int worker) {
+                for (int v = begin; v < end; v++) {
+                    if (dirty[v].load(memory_order_relaxed) && dirty[v].exchange(0, memory_order_acq_rel)) {
+                        relaxFrom(v, worker);
+                    }
+                }
+            });
+        } else {
+            pool.parallelFor(static_cast<int>(frontier.size()), FRONTIER_GRAIN, [&](int begin, int end, int worker) {
+                for (int i = begin; i < end; i++) {
+                    dirty[frontier[i]].exchange(0, memory_order_acq_rel);
+                    relaxFrom(frontier[i], worker);
+                }
+            });
+        }
+
+        // After a sweep the flags are the only record of the next frontier; collect them
+        if (dense) {
+            pool.parallelFor(num_nodes, DENSE_SWEEP_GRAIN, [&](int begin, int end, int worker) {
+                for (int v = begin; v < end; v++) {
+                    if (dirty[v].load(memory_order_relaxed)) {
+                        next[worker].push_back(v);
+                    }
+                }
+            });
+        }
+        frontier.clear();
+        for (vector<int> &local : next) {
+            frontier.insert(frontier.end(), local.begin(), local.end());
+            local.clear();
+        }
+
+        // Without a negative cycle the frontier empties within num_nodes rounds. Labels only change
+        // on a strictly shorter distance, so a cycle in the predecessor graph has negative weight
+        bool powerOfTwo = (round & (round - 1)) == 0;
+        if (!frontier.empty() && (powerOfTwo || round >= num_nodes)) {
+            result.cycle = findPredecessorCycle(label);
+            if (!result.cycle.empty()) {
+                result.negativeCycle = true;
+                result.distance = INF;
+                return result;
+            }
+        }
+    }
+
+    // A cycle closed in the last round was never checked for; the path walk would not end on it
+    result.cycle = findPredecessorCycle(label);
+    if (!result.cycle.empty()) {
+        result.negativeCycle = true;
+        result.distance = INF;
+        return result;
+    }
+
+    pair<vector<int>, int> path = extractPath(labelsToTree(label, pool), target);
+    result.path = std::move(path.first);
+    result.distance = path.second;
+    return result;
+}
+
+BellmanFordResult BellmanFordFrontier(const int num_nodes,
+                                      const int source,
+                                      const int target,
+                                      const CSRGraph &graph,
+                                      const int num_threads,
+                                      Progress *progress)
+{
+    ThreadPool pool(num_threads);
+    return BellmanFordFrontier(num_nodes, source, target, graph, pool, progress);
+}
+
+// Group the queries by source, then hand out whole groups, largest first, so one slow source
+// does not end up as the last job of the batch
+vector<pair<vector<int>, int>> BatchShortestPaths(const CSRGraph &graph,
+                                                  const vector<pair<int, int>> &queries,
+                                                  const BatchAlgorithm algorithm,
+                                                  ThreadPool &pool)
+{
+    vector<int> order(queries.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return queries[a].first < queries[b].first;
+    });
+
+    // [begin, end) ranges of order that share a source
+    vector<pair<int, int>> groups;
+    for (size_t begin = 0, end; begin < order.size(); begin = end) {
+        end = begin + 1;
+        while (end < order.size() && queries[order[end]].first == queries[order[begin]].first) {
+            end++;
+        }
+        groups.emplace_back(begin, end);
+    }
+    stable_sort(groups.begin(), groups.end(), [](const pair<int, int> &a, const pair<int, int> &b) {
+        return a.second - a.first > b.second - b.first;
+    });
+
+    vector<pair<vector<int>, int>> results(queries.size());
+    vector<QueryWorkspace> workspaces(pool.size());
+    pool.parallelFor(static_cast<int>(groups.size()), 1, [&](int begin, int end, int worker) {
+        for (int g = begin; g < end; g++) {
+            const int first = groups[g].first, last = groups[g].second;
+            const int source = queries[order[first]].first;
+
+            if (algorithm == BatchAlgorithm::Dijkstra && last - first == 1) {
+                results[order[first]] = Dijkstra(graph.numNodes(), source, queries[order[first]].second, graph, workspaces[worker]);
+                continue;
+            }
+
+            ShortestPathTree tree = algorithm == BatchAlgorithm::Dijkstra ? DijkstraTree(graph, source)
+                                                                          : BellmanFordTree(graph, source);
+            for (int i = first; i < last; i++) {
+                results[order[i]] = extractPath(tree, queries[order[i]].second);
+            }
+        }
+    });
+    return results;
+}
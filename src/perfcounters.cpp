@@ -0,0 +1,101 @@
+#include "../include/perfcounters.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// One counter of the calling thread on any CPU, in user space only; -1 if it cannot be opened
+static int openCounter(const uint32_t type, const uint64_t config, const int groupFd)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd < 0 ? 1 : 0; // the group leader starts the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+PerfCounters::PerfCounters()
+{
+    group = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, -1);
+    if (group >= 0) {
+        missFd = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, group);
+    }
+    if (missFd >= 0) {
+        l1Fd = openCounter(PERF_TYPE_HW_CACHE,
+                           PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                           group);
+    }
+    if (l1Fd < 0) {
+        reason = string("perf_event_open failed: ") + strerror(errno);
+        for (int fd : {missFd, group}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        group = missFd = -1;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int fd : {l1Fd, missFd, group}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+void PerfCounters::start()
+{
+    if (available()) {
+        ioctl(group, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PerfCounters::stop()
+{
+    if (!available()) {
+        return;
+    }
+    ioctl(group, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // PERF_FORMAT_GROUP: the number of counters, then their values in the order they were opened
+    uint64_t values[4] = {0, 0, 0, 0};
+    if (read(group, values, sizeof(values)) >= static_cast<ssize_t>(4 * sizeof(uint64_t)) && values[0] == 3) {
+        references = static_cast<long long>(values[1]);
+        misses = static_cast<long long>(values[2]);
+        l1Misses = static_cast<long long>(values[3]);
+    } else {
+        references = misses = l1Misses = -1;
+    }
+}
+
+#else
+
+PerfCounters::PerfCounters()
+    : reason("hardware counters are only read on Linux")
+{
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::start()
+{
+}
+
+void PerfCounters::stop()
+{
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include "../include/reorder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <stdexcept>
+using namespace std;
+
+string nodeOrderName(const NodeOrder order)
+{
+    switch (order) {
+    case NodeOrder::Original:
+        return "original";
+    case NodeOrder::BFS:
+        return "bfs";
+    case NodeOrder::ReverseCuthillMcKee:
+        return "rcm";
+    case NodeOrder::Degree:
+        return "degree";
+    }
+    return "original";
+}
+
+NodeOrder parseNodeOrder(const string &name)
+{
+    for (NodeOrder order : {NodeOrder::Original, NodeOrder::BFS, NodeOrder::ReverseCuthillMcKee, NodeOrder::Degree}) {
+        if (nodeOrderName(order) == name) {
+            return order;
+        }
+    }
+    throw invalid_argument("unknown node order \"" + name + "\"");
+}
+
+// Breadth-first order along the out-edges in edge order, restarted from the lowest unreached id
+static vector<int> bfsOrder(const CSRGraph &graph)
+{
+    const int n = graph.numNodes();
+    vector<int> order;
+    order.reserve(n);
+    vector<char> reached(n, 0);
+    for (int start = 0; start < n; start++) {
+        if (reached[start]) {
+            continue;
+        }
+        reached[start] = 1;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            graph.forEachEdge(order[head], [&](int toNode, int) {
+                if (!reached[toNode]) {
+                    reached[toNode] = 1;
+                    order.push_back(toNode);
+                }
+            });
+        }
+    }
+    return order;
+}
+
+// Reverse Cuthill-McKee on the undirected graph: every component is walked breadth first from a
+// node of least degree, neighbours in increasing degree, and the whole order is reversed at the end
+static vector<int> reverseCuthillMcKeeOrder(const CSRGraph &graph)
+{
+    const int n = graph.numNodes();
+
+    // The neighbour lists are sorted below, so they are copied out of the undirected graph
+    const CSRGraph undirected = graph.undirected();
+    const int *offsets = undirected.offsetsData();
+    vector<int> neighbours(undirected.targetsData(), undirected.targetsData() + undirected.numEdges());
+    auto degree = [&](int node) { return undirected.degree(node); };
+    auto byDegree = [&](int a, int b) { return degree(a) != degree(b) ? degree(a) < degree(b) : a < b; };
+    for (int node = 0; node < n; node++) {
+        sort(neighbours.begin() + offsets[node], neighbours.begin() + offsets[node + 1], byDegree);
+    }
+
+    // Components are started from their least-degree node: candidates are tried in degree order
+    vector<int> starts(n);
+    iota(starts.begin(), starts.end(), 0);
+    stable_sort(starts.begin(), starts.end(), byDegree);
+
+    vector<int> order;
+    order.reserve(n);
+    vector<char> reached(n, 0);
+    for (int start : starts) {
+        if (reached[start]) {
+            continue;
+        }
+        reached[start] = 1;
+        order.push_back(start);
+        for (size_t head = order.size() - 1; head < order.size(); head++) {
+            const int node = order[head];
+            for (int i = offsets[node]; i < offsets[node + 1]; i++) {
+                const int next = neighbours[i];
+                if (!reached[next]) {
+                    reached[next] = 1;
+                    order.push_back(next);
+                }
+            }
+        }
+    }
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+vector<int> computeNodeOrder(const CSRGraph &graph, const NodeOrder order)
+{
+    const int n = graph.numNodes();
+    switch (order) {
+    case NodeOrder::BFS:
+        return bfsOrder(graph);
+    case NodeOrder::ReverseCuthillMcKee:
+        return reverseCuthillMcKeeOrder(graph);
+    case NodeOrder::Degree: {
+        vector<int> newToOld(n);
+        iota(newToOld.begin(), newToOld.end(), 0);
+        stable_sort(newToOld.begin(), newToOld.end(), [&](int a, int b) { return graph.degree(a) > graph.degree(b); });
+        return newToOld;
+    }
+    case NodeOrder::Original:
+        break;
+    }
+    vector<int> identity(n);
+    iota(identity.begin(), identity.end(), 0);
+    return identity;
+}
+
+CSRGraph permuteGraph(const CSRGraph &graph, const vector<int> &newToOld)
+{
+    const int n = graph.numNodes();
+    if (static_cast<int>(newToOld.size()) != n) {
+        throw invalid_argument("the permutation has " + to_string(newToOld.size()) + " entries for " + to_string(n) + " nodes");
+    }
+    vector<int> oldToNew(n, -1);
+    for (int i = 0; i < n; i++) {
+        if (newToOld[i] < 0 || newToOld[i] >= n || oldToNew[newToOld[i]] != -1) {
+            throw invalid_argument("the node order is not a permutation");
+        }
+        oldToNew[newToOld[i]] = i;
+    }
+
+    vector<int> offsets(n + 1, 0);
+    vector<int> targets, weights;
+    targets.reserve(graph.numEdges());
+    weights.reserve(graph.numEdges());
+    for (int i = 0; i < n; i++) {
+        graph.forEachEdge(newToOld[i], [&](int toNode, int weight) {
+            targets.push_back(oldToNew[toNode]);
+            weights.push_back(weight);
+        });
+        offsets[i + 1] = static_cast<int>(targets.size());
+    }
+    return CSRGraph(std::move(offsets), std::move(targets), std::move(weights));
+}
+
+ReorderedGraph::ReorderedGraph(const CSRGraph &graph, const NodeOrder order)
+    : newToOld(computeNodeOrder(graph, order))
+    , oldToNew(graph.numNodes())
+{
+    for (int i = 0; i < static_cast<int>(newToOld.size()); i++) {
+        oldToNew[newToOld[i]] = i;
+    }
+    // The original order keeps the graph, including whether it is topologically ordered
+    reordered = order == NodeOrder::Original ? graph : permuteGraph(graph, newToOld);
+}
+
+pair<vector<int>, int> ReorderedGraph::dijkstra(const int source, const int target, SearchStats *stats) const
+{
+    return toOriginal(DijkstraHeap(reordered.numNodes(), oldToNew[source], oldToNew[target], reordered, stats));
+}
+
+pair<vector<int>, int> ReorderedGraph::bellmanFord(const int source, const int target, SearchStats *stats) const
+{
+    return toOriginal(BellmanFord(reordered.numNodes(), oldToNew[source], oldToNew[target], reordered, stats));
+}
+
+ShortestPathTree ReorderedGraph::tree(const int source, SearchStats *stats) const
+{
+    const ShortestPathTree relabelled = reordered.minWeight() >= 0 ? DijkstraTree(reordered, oldToNew[source], stats)
+                                                                   : BellmanFordTree(reordered, oldToNew[source], stats);
+    ShortestPathTree tree;
+    tree.distance.resize(relabelled.distance.size());
+    tree.predecessor.resize(relabelled.predecessor.size());
+    for (size_t i = 0; i < newToOld.size(); i++) {
+        tree.distance[newToOld[i]] = relabelled.distance[i];
+        tree.predecessor[newToOld[i]] = relabelled.predecessor[i] < 0 ? -1 : newToOld[relabelled.predecessor[i]];
+    }
+    return tree;
+}
+
+pair<vector<int>, int> ReorderedGraph::toOriginal(pair<vector<int>, int> path) const
+{
+    for (int &node : path.first) {
+        node = newToOld[node];
+    }
+    return path;
+}
+
+double ReorderedGraph::meanEdgeSpan() const
+{
+    if (reordered.numEdges() == 0) {
+        return 0;
+    }
+    long long span = 0;
+    for (int from = 0; from < reordered.numNodes(); from++) {
+        reordered.forEachEdge(from, [&](int toNode, int) { span += abs(toNode - from); });
+    }
+    return static_cast<double>(span) / reordered.numEdges();
+}
@@ -0,0 +1,105 @@
+#include "../include/threadpool.h"
+#include <algorithm>
+using namespace std;
+
+ThreadPool::ThreadPool(int numThreads)
+{
+    if (numThreads <= 0) {
+        numThreads = max(1u, thread::hardware_concurrency());
+    }
+    for (int i = 1; i < numThreads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// Claim chunks of the current job until none are left. A throwing body ends the job:
+// its exception is kept for parallelFor and the remaining chunks are given up
+void ThreadPool::runChunks(const int worker)
+{
+    while (true) {
+        int begin = nextIndex.fetch_add(jobGrain, memory_order_relaxed);
+        if (begin >= jobCount) {
+            return;
+        }
+        try {
+            (*job)(begin, min(begin + jobGrain, jobCount), worker);
+        } catch (...) {
+            lock_guard<mutex> guard(lock);
+            if (!failure) {
+                failure = current_exception();
+            }
+            nextIndex.store(jobCount, memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void ThreadPool::workerLoop(const int worker)
+{
+    long long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runChunks(worker);
+
+        lock_guard<mutex> guard(lock);
+        if (--busyWorkers == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(const int count, const int grain, const function<void(int, int, int)> &body)
+{
+    if (count <= 0) {
+        return;
+    }
+    // Not worth waking anyone for a single chunk
+    if (workers.empty() || count <= grain) {
+        body(0, count, 0);
+        return;
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        job = &body;
+        jobCount = count;
+        jobGrain = max(1, grain);
+        nextIndex.store(0, memory_order_relaxed);
+        busyWorkers = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    runChunks(0);
+
+    exception_ptr thrown;
+    {
+        unique_lock<mutex> guard(lock);
+        done.wait(guard, [&] { return busyWorkers == 0; });
+        job = nullptr;
+        swap(thrown, failure);
+    }
+    if (thrown) {
+        rethrow_exception(thrown);
+    }
+}
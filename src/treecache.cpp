@@ -0,0 +1,152 @@
+#include "../include/treecache.h"
+using namespace std;
+
+ShortestPathTreeCache::ShortestPathTreeCache(const size_t maxBytes)
+    : budget(maxBytes)
+{
+}
+
+void ShortestPathTreeCache::setGraph(CSRGraph newGraph)
+{
+    lock_guard<mutex> guard(lock);
+    graph = std::move(newGraph);
+    version++;
+    entries.clear();
+    bySource.clear();
+    usedBytes = 0;
+}
+
+unsigned long long ShortestPathTreeCache::graphVersion() const
+{
+    lock_guard<mutex> guard(lock);
+    return version;
+}
+
+pair<vector<int>, int> ShortestPathTreeCache::query(const int source, const int target, SearchStats *stats, Progress *progress)
+{
+    return extractPath(*tree(source, stats, progress), target);
+}
+
+shared_ptr<const ShortestPathTree> ShortestPathTreeCache::tree(const int source, SearchStats *stats, Progress *progress)
+{
+    CSRGraph current;
+    unsigned long long currentVersion;
+    {
+        lock_guard<mutex> guard(lock);
+        auto found = bySource.find(source);
+        if (found != bySource.end()) {
+            hitCount++;
+            entries.splice(entries.begin(), entries, found->second); // now the most recently used
+            return found->second->tree;
+        }
+        missCount++;
+        current = graph; // shares the arrays, so setGraph cannot free them under the search
+        currentVersion = version;
+    }
+
+    shared_ptr<const ShortestPathTree> computed = make_shared<ShortestPathTree>(
+        current.isTopologicallyOrdered() ? DAGShortestPathTree(current, source, stats, progress)
+        : current.minWeight() >= 0       ? DijkstraTree(current, source, stats, progress)
+                                         : BellmanFordTree(current, source, stats, progress));
+    const size_t bytes = treeBytes(*computed);
+
+    lock_guard<mutex> guard(lock);
+    // The graph was replaced meanwhile, or the tree alone is over budget
+    if (version != currentVersion || bytes > budget) {
+        return computed;
+    }
+    // Another thread computed the same tree meanwhile; keep the cached one
+    auto found = bySource.find(source);
+    if (found != bySource.end()) {
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->tree;
+    }
+    entries.push_front({source, computed, bytes});
+    bySource[source] = entries.begin();
+    usedBytes += bytes;
+    evictOverBudget();
+    return computed;
+}
+
+bool ShortestPathTreeCache::contains(const int source) const
+{
+    lock_guard<mutex> guard(lock);
+    return bySource.count(source) > 0;
+}
+
+void ShortestPathTreeCache::clear()
+{
+    lock_guard<mutex> guard(lock);
+    entries.clear();
+    bySource.clear();
+    usedBytes = 0;
+}
+
+void ShortestPathTreeCache::setMaxBytes(const size_t maxBytes)
+{
+    lock_guard<mutex> guard(lock);
+    budget = maxBytes;
+    evictOverBudget();
+}
+
+size_t ShortestPathTreeCache::maxBytes() const
+{
+    lock_guard<mutex> guard(lock);
+    return budget;
+}
+
+size_t ShortestPathTreeCache::memoryBytes() const
+{
+    lock_guard<mutex> guard(lock);
+    return usedBytes;
+}
+
+size_t ShortestPathTreeCache::size() const
+{
+    lock_guard<mutex> guard(lock);
+    return entries.size();
+}
+
+long long ShortestPathTreeCache::hits() const
+{
+    lock_guard<mutex> guard(lock);
+    return hitCount;
+}
+
+long long ShortestPathTreeCache::misses() const
+{
+    lock_guard<mutex> guard(lock);
+    return missCount;
+}
+
+long long ShortestPathTreeCache::evictions() const
+{
+    lock_guard<mutex> guard(lock);
+    return evictionCount;
+}
+
+double ShortestPathTreeCache::hitRate() const
+{
+    lock_guard<mutex> guard(lock);
+    const long long lookups = hitCount + missCount;
+    return lookups > 0 ? static_cast<double>(hitCount) / lookups : 0;
+}
+
+// The two label arrays plus the list node, hash node and control block around them
+size_t ShortestPathTreeCache::treeBytes(const ShortestPathTree &tree)
+{
+    return (tree.distance.capacity() + tree.predecessor.capacity()) * sizeof(int)
+           + sizeof(ShortestPathTree) + sizeof(Entry) + 6 * sizeof(void *);
+}
+
+// Drops least recently used trees until the rest fit; the caller holds the lock
+void ShortestPathTreeCache::evictOverBudget()
+{
+    while (usedBytes > budget && !entries.empty()) {
+        const Entry &last = entries.back();
+        usedBytes -= last.bytes;
+        bySource.erase(last.source);
+        entries.pop_back();
+        evictionCount++;
+    }
+}
@@ -0,0 +1,241 @@
+#include "../include/typedgraph.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+using namespace std;
+
+// Whether id is one of the nodes 0..nodes - 1
+template<typename NodeId>
+static bool isNode(const NodeId id, const size_t nodes)
+{
+    if constexpr (is_signed<NodeId>::value) {
+        if (id < 0) {
+            return false;
+        }
+    }
+    return static_cast<size_t>(id) < nodes;
+}
+
+template<typename NodeId, typename Weight>
+BasicCSRGraph<NodeId, Weight>::BasicCSRGraph(vector<EdgeIndex> offsets, vector<NodeId> targets, vector<Weight> weights)
+    : offsets(std::move(offsets)), targets(std::move(targets)), weights(std::move(weights))
+{
+    const size_t nodes = this->offsets.size() - 1;
+    if (this->offsets.empty() || this->offsets.front() != 0 || this->offsets.back() != this->targets.size()
+        || this->targets.size() != this->weights.size() || !is_sorted(this->offsets.begin(), this->offsets.end())) {
+        throw invalid_argument("edge offsets do not match the edge arrays");
+    }
+    for (NodeId target : this->targets) {
+        if (!isNode(target, nodes)) {
+            throw invalid_argument("edge target " + to_string(target) + " is not a node");
+        }
+    }
+    if (!this->weights.empty()) {
+        const auto range = minmax_element(this->weights.begin(), this->weights.end());
+        minEdgeWeight = *range.first;
+        maxEdgeWeight = *range.second;
+    }
+}
+
+template<typename NodeId, typename Weight>
+bool BasicCSRGraph<NodeId, Weight>::fits(const CSRGraph &graph)
+{
+    // The node count itself must fit too: numNodes() returns it as a NodeId
+    const bool idsFit = static_cast<unsigned long long>(graph.numNodes()) <= static_cast<unsigned long long>(numeric_limits<NodeId>::max())
+                        && static_cast<unsigned long long>(graph.numEdges()) <= numeric_limits<EdgeIndex>::max();
+    if constexpr (is_floating_point<Weight>::value) {
+        return idsFit; // every int is representable, if not always exactly in float
+    } else {
+        return idsFit && graph.minWeight() >= numeric_limits<Weight>::lowest() && graph.maxWeight() <= numeric_limits<Weight>::max();
+    }
+}
+
+template<typename NodeId, typename Weight>
+BasicCSRGraph<NodeId, Weight> BasicCSRGraph<NodeId, Weight>::fromCSR(const CSRGraph &graph)
+{
+    if (!fits(graph)) {
+        throw out_of_range("the graph's node ids or weights " + to_string(graph.minWeight()) + ".."
+                           + to_string(graph.maxWeight()) + " do not fit the narrower types");
+    }
+    const int nodes = graph.numNodes();
+    const int edges = graph.numEdges();
+    return BasicCSRGraph(vector<EdgeIndex>(graph.offsetsData(), graph.offsetsData() + nodes + 1),
+                         vector<NodeId>(graph.targetsData(), graph.targetsData() + edges),
+                         vector<Weight>(graph.weightsData(), graph.weightsData() + edges));
+}
+
+// distance + weight in Distance; integer sums saturate to the largest or smallest finite distance
+template<typename Distance, typename Weight>
+static inline Distance extend(const Distance distance, const Weight weight, bool &saturated)
+{
+    const Distance step = static_cast<Distance>(weight);
+    if constexpr (is_floating_point<Distance>::value) {
+        return distance + step;
+    } else {
+        const Distance largest = numeric_limits<Distance>::max() - 1; // max() means unreachable
+        if (step > 0 && distance > largest - step) {
+            saturated = true;
+            return largest;
+        }
+        if (step < 0 && distance < numeric_limits<Distance>::lowest() - step) {
+            saturated = true;
+            return numeric_limits<Distance>::lowest();
+        }
+        return distance + step;
+    }
+}
+
+// Dijkstra's algorithm with a binary heap, as dijkstraSearch in algorithm.cpp
+template<typename Distance, typename NodeId, typename Weight, typename Stats>
+static void typedDijkstra(const BasicCSRGraph<NodeId, Weight> &graph,
+                          const NodeId source,
+                          BasicShortestPathTree<NodeId, Distance> &tree,
+                          Stats &stats)
+{
+    const greater<> heapOrder;
+    vector<pair<Distance, NodeId>> heap;
+    tree.distance[source] = 0;
+    heap.emplace_back(0, source);
+    stats.onRound();
+    stats.onPush(heap.size());
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), heapOrder);
+        const auto [distance, from] = heap.back();
+        heap.pop_back();
+        stats.onPop();
+        if (distance > tree.distance[from]) {
+            stats.onStale();
+            continue;
+        }
+        stats.onSettle();
+
+        for (auto e = graph.edgesBegin(from); e < graph.edgesEnd(from); e++) {
+            stats.onRelax();
+            const NodeId to = graph.target(e);
+            const Distance candidate = extend(distance, graph.weight(e), tree.saturated);
+            if (candidate < tree.distance[to]) {
+                tree.distance[to] = candidate;
+                tree.predecessor[to] = from;
+                stats.onImprove();
+                heap.emplace_back(candidate, to);
+                push_heap(heap.begin(), heap.end(), heapOrder);
+                stats.onPush(heap.size());
+            }
+        }
+    }
+}
+
+// Bellman-Ford, as bellmanFordSearch in algorithm.cpp
+template<typename Distance, typename NodeId, typename Weight, typename Stats>
+static void typedBellmanFord(const BasicCSRGraph<NodeId, Weight> &graph,
+                             const NodeId source,
+                             BasicShortestPathTree<NodeId, Distance> &tree,
+                             Stats &stats)
+{
+    const NodeId nodes = graph.numNodes();
+    const Distance unreachable = BasicShortestPathTree<NodeId, Distance>::unreachable();
+    tree.distance[source] = 0;
+
+    // Relax all edges up to (num_nodes - 1) times, stopping early once nothing changes
+    for (NodeId round = 1; round < nodes; round++) {
+        bool updated = false;
+        stats.onRound();
+        for (NodeId from = 0; from < nodes; from++) {
+            const Distance distance = tree.distance[from];
+            if (distance == unreachable) {
+                continue;
+            }
+            stats.onSettle();
+            for (auto e = graph.edgesBegin(from); e < graph.edgesEnd(from); e++) {
+                stats.onRelax();
+                const NodeId to = graph.target(e);
+                const Distance candidate = extend(distance, graph.weight(e), tree.saturated);
+                if (candidate < tree.distance[to]) {
+                    tree.distance[to] = candidate;
+                    tree.predecessor[to] = from;
+                    stats.onImprove();
+                    updated = true;
+                }
+            }
+        }
+        if (!updated) {
+            break;
+        }
+    }
+}
+
+// Allocates the tree and runs search with SearchStats if stats is given and with NoStats otherwise
+template<typename Distance, typename NodeId, typename Weight, typename Search>
+static BasicShortestPathTree<NodeId, Distance> typedTree(const BasicCSRGraph<NodeId, Weight> &graph,
+                                                         const NodeId source,
+                                                         SearchStats *stats,
+                                                         Search &&search)
+{
+    static_assert(is_floating_point<Distance>::value || !is_floating_point<Weight>::value,
+                  "floating-point weights need a floating-point distance");
+    static_assert(numeric_limits<Distance>::max() >= numeric_limits<Weight>::max(), "the distance type must hold every weight");
+
+    if (!isNode(source, graph.numNodes())) {
+        throw invalid_argument("source " + to_string(source) + " is not a node");
+    }
+    BasicShortestPathTree<NodeId, Distance> tree;
+    tree.distance.assign(graph.numNodes(), BasicShortestPathTree<NodeId, Distance>::unreachable());
+    tree.predecessor.assign(graph.numNodes(), BasicCSRGraph<NodeId, Weight>::NO_NODE);
+    if (stats) {
+        search(tree, *stats);
+    } else {
+        NoStats none;
+        search(tree, none);
+    }
+    return tree;
+}
+
+template<typename Distance, typename NodeId, typename Weight>
+BasicShortestPathTree<NodeId, Distance> DijkstraTree(const BasicCSRGraph<NodeId, Weight> &graph,
+                                                     const NodeId source,
+                                                     SearchStats *stats)
+{
+    if (graph.minWeight() < 0) {
+        throw invalid_argument("Dijkstra needs non-negative weights");
+    }
+    return typedTree<Distance>(graph, source, stats, [&](auto &tree, auto &policy) {
+        typedDijkstra(graph, source, tree, policy);
+    });
+}
+
+template<typename Distance, typename NodeId, typename Weight>
+BasicShortestPathTree<NodeId, Distance> BellmanFordTree(const BasicCSRGraph<NodeId, Weight> &graph,
+                                                        const NodeId source,
+                                                        SearchStats *stats)
+{
+    return typedTree<Distance>(graph, source, stats, [&](auto &tree, auto &policy) {
+        typedBellmanFord(graph, source, tree, policy);
+    });
+}
+
+// The graph types compiled ahead of time, declared extern in typedgraph.h
+template class BasicCSRGraph<int32_t, int32_t>;
+template class BasicCSRGraph<uint32_t, int8_t>;
+template class BasicCSRGraph<uint32_t, int16_t>;
+template class BasicCSRGraph<uint32_t, int32_t>;
+template class BasicCSRGraph<uint32_t, float>;
+
+// Their searches: integer weights summed in int32_t or int64_t, float weights in float or double
+#define INSTANTIATE_TYPED_SEARCHES(NodeId, Weight, Distance)                                                        \
+    template BasicShortestPathTree<NodeId, Distance> DijkstraTree<Distance>(const BasicCSRGraph<NodeId, Weight> &,  \
+                                                                           NodeId, SearchStats *);                 \
+    template BasicShortestPathTree<NodeId, Distance> BellmanFordTree<Distance>(const BasicCSRGraph<NodeId, Weight> &, \
+                                                                              NodeId, SearchStats *);
+
+INSTANTIATE_TYPED_SEARCHES(int32_t, int32_t, int32_t)
+INSTANTIATE_TYPED_SEARCHES(int32_t, int32_t, int64_t)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, int8_t, int32_t)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, int8_t, int64_t)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, int16_t, int32_t)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, int16_t, int64_t)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, int32_t, int32_t)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, int32_t, int64_t)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, float, float)
+INSTANTIATE_TYPED_SEARCHES(uint32_t, float, double)
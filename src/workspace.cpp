@@ -0,0 +1,27 @@
+#include "../include/workspace.h"
+using namespace std;
+
+QueryWorkspace::QueryWorkspace(const int num_nodes)
+    : labels(num_nodes, {numeric_limits<int>::max(), -1, 0})
+{
+}
+
+void QueryWorkspace::begin(const int num_nodes)
+{
+    if (static_cast<int>(labels.size()) < num_nodes) {
+        labels.resize(num_nodes, {numeric_limits<int>::max(), -1, 0});
+    }
+
+    // Version 0 is never current, so fresh labels (and all labels after a wrap) read as unreached
+    if (++version == 0) {
+        for (Label &label : labels) {
+            label.version = 0;
+        }
+        version = 1;
+    }
+
+    heapBuffer.clear();
+    for (vector<int> &bucket : bucketBuffer) {
+        bucket.clear();
+    }
+}